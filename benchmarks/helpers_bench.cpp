@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flexi_cfg/config/classes.h"
+#include "flexi_cfg/config/helpers.h"
+#include "flexi_cfg/math/program.h"
+
+namespace {
+
+using flexi_cfg::config::types::CfgMap;
+using flexi_cfg::config::types::ConfigValue;
+using flexi_cfg::config::types::RefMap;
+using flexi_cfg::config::types::Type;
+
+/// \brief The ref vars of a typical reference (see `generator::Options::references_per_proto`).
+auto refVars() -> RefMap {
+  return {{"$NAME", std::make_shared<ConfigValue>(R"("s1.n1.r0_1")", Type::kString)},
+          {"$PARENT_NAME", std::make_shared<ConfigValue>(R"("r0_1")", Type::kString)},
+          {"$SCALE", std::make_shared<ConfigValue>("12.5", Type::kNumber)},
+          {"$OFFSET", std::make_shared<ConfigValue>("-3", Type::kNumber)}};
+}
+
+void BM_ReplaceVarInStr(benchmark::State& bm_state, const std::string& input, RefMap ref_vars) {
+  for (auto _ : bm_state) {
+    auto out = flexi_cfg::config::helpers::replaceVarInStr(input, ref_vars);
+    benchmark::DoNotOptimize(out);
+  }
+}
+
+// A string without any vars is the common case.
+BENCHMARK_CAPTURE(BM_ReplaceVarInStr, NoVars, std::string("a plain string value"), refVars());
+BENCHMARK_CAPTURE(BM_ReplaceVarInStr, OneVar, std::string("${NAME}.k1"), refVars());
+BENCHMARK_CAPTURE(BM_ReplaceVarInStr, ManyVars,
+                  std::string("$NAME: $SCALE * x + $OFFSET (${PARENT_NAME}, ${SCALE})"),
+                  refVars());
+// A var whose value refers to another var has its value scanned again.
+BENCHMARK_CAPTURE(BM_ReplaceVarInStr, NestedVar, std::string("${NAME}.k1"),
+                  RefMap{{"$NAME", std::make_shared<ConfigValue>(R"("$PARENT")", Type::kString)},
+                         {"$PARENT", std::make_shared<ConfigValue>(R"("p")", Type::kString)}});
+
+/// \brief A struct with `n` numeric values, as found in a parsed config.
+auto cfgMap(int64_t n) -> CfgMap {
+  CfgMap map;
+  for (int64_t i = 0; i < n; ++i) {
+    map[fmt::format("key_{}", i)] = std::make_shared<ConfigValue>("1.5", Type::kNumber);
+  }
+  return map;
+}
+
+// Walking every key/value pair of a struct is what the resolver & visitors do most.
+void BM_CfgMapIterate(benchmark::State& bm_state) {
+  const auto map = cfgMap(bm_state.range(0));
+  for (auto _ : bm_state) {
+    for (const auto& [key, value] : map) {
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations() * bm_state.range(0));
+}
+BENCHMARK(BM_CfgMapIterate)->Range(8, 4096);
+
+void BM_CfgMapFind(benchmark::State& bm_state) {
+  const auto map = cfgMap(bm_state.range(0));
+  const auto key = fmt::format("key_{}", bm_state.range(0) / 2);
+  for (auto _ : bm_state) {
+    auto it = map.find(key);
+    benchmark::DoNotOptimize(it);
+  }
+}
+BENCHMARK(BM_CfgMapFind)->Range(8, 4096);
+
+const std::string kExpression{"{{ 3 * $(a.b) - 2.3 ** $(c) - 5 * -($(a.b) + pi) / 4 }}"};
+
+void BM_CompileExpression(benchmark::State& bm_state) {
+  for (auto _ : bm_state) {
+    auto program = flexi_cfg::math::compile(kExpression, "bench");
+    benchmark::DoNotOptimize(program);
+  }
+}
+BENCHMARK(BM_CompileExpression);
+
+// Evaluating a compiled program is what happens for every copy of an expression.
+void BM_EvaluateProgram(benchmark::State& bm_state) {
+  const auto program = flexi_cfg::math::compile(kExpression, "bench");
+  const std::vector<double> values{0.27, 0.5};
+  for (auto _ : bm_state) {
+    auto res = program->evaluate(values);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(BM_EvaluateProgram);
+
+}  // namespace
@@ -0,0 +1,268 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <magic_enum.hpp>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flexi_cfg/config/actions.h"
+#include "flexi_cfg/generator.h"
+#include "flexi_cfg/logger.h"
+#include "flexi_cfg/parser.h"
+#include "flexi_cfg/reader.h"
+
+namespace {
+
+/// \brief Exposes the individual phases of the parser so that they can be timed separately.
+class PhaseParser : public flexi_cfg::Parser {
+ public:
+  PhaseParser() = default;
+
+  using Parser::Phase;
+  using Parser::parseFileToState;
+  using Parser::parseStringToState;
+  using Parser::resolvePhase;
+};
+
+/// \brief A single benchmark input. Either a config file on disk or an in-memory config string.
+struct Input {
+  std::string name;
+  std::filesystem::path file{};
+  std::string contents{};
+
+  [[nodiscard]] auto parse() const -> flexi_cfg::Reader {
+    return file.empty() ? flexi_cfg::Parser::parseFromString(contents, name)
+                        : flexi_cfg::Parser::parse(file);
+  }
+
+  [[nodiscard]] auto parseToState(unsigned threads = 1) const -> flexi_cfg::config::ActionData {
+    return file.empty() ? PhaseParser::parseStringToState(contents, name)
+                        : PhaseParser::parseFileToState(file, std::nullopt, threads);
+  }
+};
+
+auto exampleInputs() -> std::vector<Input> {
+  // Only the top level examples are complete configs. Everything else is meant to be included.
+  const std::regex re_config(R"(config_example\d+\.cfg)");
+  std::vector<Input> inputs;
+  for (const auto& entry : std::filesystem::directory_iterator(EXAMPLE_DIR)) {
+    const auto filename = entry.path().filename().string();
+    if (entry.is_regular_file() && std::regex_match(filename, re_config)) {
+      inputs.push_back({.name = filename, .file = entry.path()});
+    }
+  }
+  std::ranges::sort(inputs, {}, &Input::name);
+  return inputs;
+}
+
+auto syntheticInputs() -> std::vector<Input> {
+  std::vector<Input> inputs;
+  for (const std::size_t n_keys : {1000, 10000, 100000}) {
+    // Everything in a single config string.
+    auto options = flexi_cfg::generator::optionsForKeyCount(n_keys);
+    options.include_files = 0;
+    inputs.push_back({.name = fmt::format("synthetic_{}", n_keys),
+                      .contents = flexi_cfg::generator::generate(options).root()});
+
+    // The same number of keys spread across a number of included files.
+    const auto name = fmt::format("synthetic_{}_includes", n_keys);
+    const auto generated =
+        flexi_cfg::generator::generate(flexi_cfg::generator::optionsForKeyCount(n_keys));
+    const auto dir = std::filesystem::temp_directory_path() / "flexi_cfg_bench" / name;
+    inputs.push_back({.name = name, .file = generated.write(dir)});
+  }
+  return inputs;
+}
+
+void BM_Parse(benchmark::State& bm_state, const Input& input) {
+  for (auto _ : bm_state) {
+    auto cfg = input.parse();
+    benchmark::DoNotOptimize(cfg);
+  }
+}
+
+void BM_PegParse(benchmark::State& bm_state, const Input& input) {
+  for (auto _ : bm_state) {
+    auto state = input.parseToState();
+    benchmark::DoNotOptimize(state);
+  }
+}
+
+/// \brief Parses the files of a config (and its includes) on an increasing number of threads.
+void BM_PegParseThreaded(benchmark::State& bm_state, const Input& input) {
+  const auto threads = static_cast<unsigned>(bm_state.range(0));
+  for (auto _ : bm_state) {
+    auto state = input.parseToState(threads);
+    benchmark::DoNotOptimize(state);
+  }
+}
+
+/// \brief Times a single phase of `Parser::resolveConfig`. All of the preceding phases are run on a
+///        freshly parsed input outside of the timed region for every iteration.
+void BM_ResolvePhase(benchmark::State& bm_state, const Input& input, PhaseParser::Phase phase) {
+  for (auto _ : bm_state) {
+    PhaseParser parser;
+    auto state = input.parseToState();
+    for (const auto prior : magic_enum::enum_values<PhaseParser::Phase>()) {
+      if (prior == phase) {
+        break;
+      }
+      parser.resolvePhase(prior, state);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    parser.resolvePhase(phase, state);
+    const auto end = std::chrono::steady_clock::now();
+
+    bm_state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+}
+
+/// \brief Collects the full keys of all of the numeric values in the config.
+void numericKeys(const flexi_cfg::Reader& cfg, const std::string& parent,
+                 std::vector<std::string>& out) {
+  for (const auto& key : cfg.keys()) {
+    const auto full_key = parent.empty() ? key : fmt::format("{}.{}", parent, key);
+    const auto type = cfg.getType(key);
+    if (type == flexi_cfg::config::types::Type::kNumber) {
+      out.push_back(full_key);
+    } else if (type == flexi_cfg::config::types::Type::kStruct ||
+               type == flexi_cfg::config::types::Type::kStructInProto) {
+      numericKeys(cfg.getValue<flexi_cfg::Reader>(key), full_key, out);
+    }
+  }
+}
+
+/// \brief Reads every numeric value in the config (by its full key).
+void BM_Read(benchmark::State& bm_state, const Input& input, bool frozen) {
+  auto cfg = input.parse();
+  if (frozen) {
+    cfg.freeze();
+  }
+  std::vector<std::string> keys;
+  numericKeys(cfg, "", keys);
+  for (auto _ : bm_state) {
+    for (const auto& key : keys) {
+      auto value = cfg.getValue<double>(key);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  bm_state.SetItemsProcessed(static_cast<int64_t>(bm_state.iterations() * keys.size()));
+}
+
+/// \brief Reads every numeric value in the config through handles created up front.
+void BM_ReadKeys(benchmark::State& bm_state, const Input& input, bool frozen) {
+  auto cfg = input.parse();
+  if (frozen) {
+    cfg.freeze();
+  }
+  std::vector<std::string> names;
+  numericKeys(cfg, "", names);
+  std::vector<flexi_cfg::Reader::TypedKey<double>> keys;
+  for (const auto& name : names) {
+    keys.push_back(cfg.key<double>(name));
+  }
+  for (auto _ : bm_state) {
+    for (const auto& key : keys) {
+      auto value = cfg.getValue(key);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  bm_state.SetItemsProcessed(static_cast<int64_t>(bm_state.iterations() * keys.size()));
+}
+
+/// \brief Reads numeric values in a random order from a frozen config shared by all of the threads.
+///        The items per second should scale linearly with the number of threads.
+void BM_ReadThreaded(benchmark::State& bm_state, const Input& input) {
+  // The first thread sets up the config. The other threads wait for it before starting the loop.
+  static std::optional<flexi_cfg::Reader> cfg;
+  static std::vector<std::string> keys;
+  if (bm_state.thread_index() == 0) {
+    cfg = input.parse();
+    cfg->freeze();
+    keys.clear();
+    numericKeys(*cfg, "", keys);
+    std::ranges::shuffle(keys, std::mt19937{1});
+  }
+  for (auto _ : bm_state) {
+    // Each thread starts at a different position, so they aren't reading the same keys in step.
+    const auto offset = keys.size() * static_cast<std::size_t>(bm_state.thread_index()) /
+                        static_cast<std::size_t>(bm_state.threads());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      auto value = cfg->getValue<double>(keys[(offset + i) % keys.size()]);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  bm_state.SetItemsProcessed(static_cast<int64_t>(bm_state.iterations() * keys.size()));
+  if (bm_state.thread_index() == 0) {
+    cfg.reset();
+  }
+}
+
+void registerBenchmarks(const std::vector<Input>& inputs) {
+  for (const auto& input : inputs) {
+    benchmark::RegisterBenchmark(fmt::format("Parse/{}", input.name).c_str(), BM_Parse, input)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(fmt::format("PegParse/{}", input.name).c_str(), BM_PegParse,
+                                 input)
+        ->Unit(benchmark::kMicrosecond);
+    if (!input.file.empty()) {
+      benchmark::RegisterBenchmark(fmt::format("PegParseThreaded/{}", input.name).c_str(),
+                                   BM_PegParseThreaded, input)
+          ->RangeMultiplier(2)
+          ->Range(1, static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency())))
+          ->UseRealTime()
+          ->Unit(benchmark::kMicrosecond);
+    }
+    benchmark::RegisterBenchmark(fmt::format("Read/{}", input.name).c_str(), BM_Read, input,
+                                 false)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(fmt::format("ReadFrozen/{}", input.name).c_str(), BM_Read, input,
+                                 true)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(fmt::format("ReadKeys/{}", input.name).c_str(), BM_ReadKeys,
+                                 input, false)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(fmt::format("ReadKeysFrozen/{}", input.name).c_str(),
+                                 BM_ReadKeys, input, true)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(fmt::format("ReadThreaded/{}", input.name).c_str(),
+                                 BM_ReadThreaded, input)
+        ->ThreadRange(1, static_cast<int>(std::max(1U, std::thread::hardware_concurrency())))
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+    for (const auto phase : magic_enum::enum_values<PhaseParser::Phase>()) {
+      benchmark::RegisterBenchmark(
+          fmt::format("{}/{}", magic_enum::enum_name(phase).substr(1), input.name).c_str(),
+          BM_ResolvePhase, input, phase)
+          ->UseManualTime()
+          ->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  // Logging is not what is being measured here.
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::ERROR);
+
+  registerBenchmarks(exampleInputs());
+  registerBenchmarks(syntheticInputs());
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
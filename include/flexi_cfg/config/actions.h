@@ -19,19 +19,31 @@
 
 #include "flexi_cfg/config/classes.h"
 #include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/config/files.h"
 #include "flexi_cfg/config/grammar.h"
 #include "flexi_cfg/config/helpers.h"
 #include "flexi_cfg/config/parser-internal.h"
 #include "flexi_cfg/logger.h"
+#include "flexi_cfg/math/program.h"
+#include "flexi_cfg/stats.h"
 #include "flexi_cfg/utils.h"
 
+// Only build the indentation (and evaluate the arguments) if the message will be logged.
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define CONFIG_ACTION_DEBUG(MSG_F, ...) \
-  logger::debug("{}" MSG_F, std::string(out.depth * 2UL, ' '), ##__VA_ARGS__);
+#define CONFIG_ACTION_DEBUG(MSG_F, ...)                                            \
+  do {                                                                             \
+    if (logger::enabled(logger::Severity::DEBUG)) {                                \
+      logger::debug("{}" MSG_F, std::string(out.depth * 2UL, ' '), ##__VA_ARGS__); \
+    }                                                                              \
+  } while (false)
 
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define CONFIG_ACTION_TRACE(MSG_F, ...) \
-  logger::trace("{}" MSG_F, std::string(out.depth * 2UL, ' '), ##__VA_ARGS__);
+#define CONFIG_ACTION_TRACE(MSG_F, ...)                                            \
+  do {                                                                             \
+    if (logger::enabled(logger::Severity::TRACE)) {                                \
+      logger::trace("{}" MSG_F, std::string(out.depth * 2UL, ' '), ##__VA_ARGS__); \
+    }                                                                              \
+  } while (false)
 
 namespace flexi_cfg::config {
 
@@ -63,6 +75,21 @@ struct ActionData {
   std::filesystem::path base_dir;
   std::optional<IncludeData> include_pending;
   std::unordered_set<std::filesystem::path, path_hash> all_files{};  // catch duplicate includes
+
+  // How `include` statements are handled. Files can be parsed concurrently by first discovering
+  // all of the includes, then parsing each file on its own (skipping its includes).
+  enum class IncludeMode {
+    kParse,     // parse each included file in place
+    kDiscover,  // only parse the `include` statements of each included file
+    kSkip       // ignore `include` statements
+  };
+  IncludeMode include_mode{IncludeMode::kParse};
+  // [kDiscover] the included files, in the order in which a `kParse` parse would finish them
+  std::vector<std::filesystem::path> include_order;
+  // The contents of all of the files read during the parse (shared with the error handling).
+  std::shared_ptr<FileTable> files{std::make_shared<FileTable>()};
+  // The source of the last node (see `source`)
+  types::Source last_source{};
   std::string result{DEFAULT_RES};
   std::vector<std::string> keys;
   std::vector<std::string> flat_keys;
@@ -96,6 +123,15 @@ struct ActionData {
   bool is_override{false};
   types::CfgMap override_values;  // A set of FLAT_KEY / VALUE pairs (to be resolved later)
 
+  /// \brief The shared name of the source of a node (see `FileTable::source`). Consecutive nodes
+  ///        are almost always from the same source, so the last one is kept.
+  auto source(std::string_view name) -> types::Source {
+    if (last_source == nullptr || *last_source != name) {
+      last_source = files->source(name);
+    }
+    return last_source;
+  }
+
   void print(std::ostream& os) const {
     if (in_proto) {
       os << "current proto key: " << proto_key << "\n";
@@ -204,8 +240,8 @@ struct action<VALUE> {
 #if VERBOSE_DEBUG_ACTIONS
     CONFIG_ACTION_TRACE("In VALUE ({}) action: {}", out.obj_res->type, in.string());
 #endif
-    out.obj_res->line = in.position().line;
-    out.obj_res->source = in.position().source;
+    out.obj_res->line = in.iterator().line;
+    out.obj_res->source = out.source(in.input().source());
   }
 };
 
@@ -318,7 +354,7 @@ struct action<LIST::element> {
                       key, out.obj_res->loc(), out.obj_res->type,
                       out.lists.back()->list_element_type, out.lists.back()->type);
     }
-    out.lists.back()->data.push_back(std::move(out.obj_res));
+    out.lists.back()->append(std::move(out.obj_res));
     // Set the moved object to null so it isn't left in an invalid state
     out.obj_res = nullptr;
   }
@@ -347,7 +383,7 @@ struct action<PROTO_LIST::element> {
                       key, out.obj_res->loc(), out.obj_res->type,
                       out.lists.back()->list_element_type, out.lists.back()->type);
     }
-    out.lists.back()->data.push_back(std::move(out.obj_res));
+    out.lists.back()->append(std::move(out.obj_res));
     // Set the moved object to null so it isn't left in an invalid state
     out.obj_res = nullptr;
   }
@@ -372,10 +408,16 @@ struct action<EXPRESSION> {
                         ranges::views::values(out.value_lookups));
     // Grab the entire input and stuff it into a ConfigExpression. We'll properly evaluate it later.
 
-    out.obj_res = std::make_shared<types::ConfigExpression>(in.string(), out.value_lookups);
+    auto expression = std::make_shared<types::ConfigExpression>(in.string(), out.value_lookups);
+    // Compile it now so that all copies (e.g. every instance of a proto) share a single program.
+    // Expressions containing vars are rewritten once the vars are known, so compile those later.
+    if (!expression->hasVars()) {
+      expression->program = math::compile(expression->value, in.position().source);
+    }
+    out.obj_res = std::move(expression);
     out.value_lookups.clear();
-    out.obj_res->line = in.position().line;
-    out.obj_res->source = in.position().source;
+    out.obj_res->line = in.iterator().line;
+    out.obj_res->source = out.source(in.input().source());
   }
 };
 
@@ -392,8 +434,8 @@ struct action<VAR> {
     out.result = in.string();
 
     out.obj_res = std::make_shared<types::ConfigVar>(in.string());
-    out.obj_res->line = in.position().line;
-    out.obj_res->source = in.position().source;
+    out.obj_res->line = in.iterator().line;
+    out.obj_res->source = out.source(in.input().source());
   }
 };
 
@@ -461,6 +503,9 @@ struct base_include_action {
   static void apply(const ActionInput& in, ActionData& out) {
     assert(out.include_pending.has_value());
     auto incl = std::move(out.include_pending.value());
+    if (out.include_mode == ActionData::IncludeMode::kSkip) {
+      return;
+    }
     CONFIG_ACTION_DEBUG("Found include file: {} - (optional: {}, relative: {}, once: {})",
                         incl.file, incl.is_optional, incl.is_relative, incl.is_once);
 
@@ -484,13 +529,15 @@ struct base_include_action {
           path_base = current_file_source.parent_path();
         }
         // If the condition above is false, path_base remains out.base_dir (its initial value).
-        // This correctly handles the fallback for unusable sources like "from_content" or just a filename.
+        // This correctly handles the fallback for unusable sources like "from_content" or just a
+        // filename.
       }
 
       const auto cfg_file =
           absolute(is_absolute ? std::filesystem::path(incl.file) : path_base / incl.file);
 
-      CONFIG_ACTION_DEBUG("Resolved include: {} (is_relative: {}, is_absolute: {}, path_base: {})", cfg_file.string(), incl.is_relative, is_absolute, path_base.string());
+      CONFIG_ACTION_DEBUG("Resolved include: {} (is_relative: {}, is_absolute: {}, path_base: {})",
+                          cfg_file.string(), incl.is_relative, is_absolute, path_base.string());
 
       if (!exists(cfg_file)) {
         if (incl.is_optional) {
@@ -508,14 +555,15 @@ struct base_include_action {
       if (incl.is_relative) [[unlikely]] {
         base_dir_override.override(cfg_file.parent_path());
       }
-      peg::file_input include_file(cfg_file);
-
       if (out.all_files.contains(cfg_file)) {
         if (incl.is_once) {
           logger::warn("Skipping [once] include (duplicate): {} -> {}", source, cfg_file.string());
           return;
         } else {
-          logger::error("Duplicate include file detected: {}", cfg_file.string());
+          // A failed discovery is followed by a regular parse, which reports the error.
+          if (out.include_mode != ActionData::IncludeMode::kDiscover) {
+            logger::error("Duplicate include file detected: {}", cfg_file.string());
+          }
           throw peg::parse_error(
               fmt::format(
                   "duplicate includes are not allowed, consider using 'include [once] {}' -> {}",
@@ -523,9 +571,20 @@ struct base_include_action {
               in.position());
         }
       }
+      auto include_file = out.files->open(cfg_file).input();
       out.all_files.insert(cfg_file);
+      if (out.include_mode == ActionData::IncludeMode::kDiscover) {
+        // Includes are only allowed at the top of a file, so the rest of it can be skipped.
+        internal::parseNestedCore<peg::seq<TAIL, includes>, action, control>(in.position(),
+                                                                            include_file, out);
+        out.include_order.push_back(cfg_file);
+        return;
+      }
       logger::debug("Begin nested parse: {}", cfg_file.string());
-      internal::parseNestedCore<grammar, action, control>(in.position(), include_file, out);
+      {
+        const stats::ScopedTimer timer{&ParseStats::files, cfg_file.string()};
+        internal::parseNestedCore<grammar, action, control>(in.position(), include_file, out);
+      }
       logger::debug("End nested parse: {}", cfg_file.string());
     } catch (const std::system_error& e) {
       throw peg::parse_error(fmt::format("Include error: {}", e.what()), in.position());
@@ -603,8 +662,8 @@ struct action<VALUE_LOOKUP> {
     }
     auto val_lookup = std::make_shared<types::ConfigValueLookup>(var_ref);
     out.obj_res = val_lookup;
-    out.obj_res->source = in.position().source;
-    out.obj_res->line = in.position().line;
+    out.obj_res->source = out.source(in.input().source());
+    out.obj_res->line = in.iterator().line;
     out.value_lookups[var_ref] = val_lookup;
   }
 };
@@ -3,22 +3,35 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <algorithm>
 #include <any>
+#include <cstdint>
 #include <iosfwd>
 #include <magic_enum.hpp>
 #include <map>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <variant>
 #include <vector>
 
+#include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/details/from_chars.h"
 #include "flexi_cfg/details/ordered_map.h"
 #include "flexi_cfg/logger.h"
+#include "flexi_cfg/stats.h"
 #include "flexi_cfg/utils.h"
 
 #define DEBUG_CLASSES 0
 #define PRINT_SRC 1  // NOLINT(cppcoreguidelines-macro-usage)
 
+namespace flexi_cfg::math {
+struct Program;
+}  // namespace flexi_cfg::math
+
 namespace flexi_cfg::config::types {
 constexpr std::size_t tw{4};  // The width of the indentation
 
@@ -26,7 +39,7 @@ class ConfigBase;
 using BasePtr = std::shared_ptr<ConfigBase>;
 
 using CfgMap = details::ordered_map<std::string, BasePtr, details::string_hash>;
-using RefMap = std::map<std::string, BasePtr>;
+using RefMap = std::map<std::string, BasePtr, std::less<>>;
 class ConfigProto;
 using ProtoMap = std::map<std::string, std::shared_ptr<ConfigProto>>;
 
@@ -53,10 +66,14 @@ inline auto operator<<(std::ostream& os, const Type& type) -> std::ostream& {
   return os << magic_enum::enum_name<config::types::Type>(type);
 }
 
+/// The name of the source (e.g. the file) of a node. The nodes of a parse share a single copy of
+/// each name (see `FileTable::source`).
+using Source = std::shared_ptr<const std::string>;
+
 // This is the base-class from which all config nodes shall derive
 class ConfigBase {
  public:
-  virtual ~ConfigBase() noexcept = default;
+  virtual ~ConfigBase() noexcept { stats::nodeDestroyed(); }
   auto operator=(const ConfigBase&) -> ConfigBase& = delete;
   auto operator=(ConfigBase&&) -> ConfigBase& = delete;
 
@@ -64,18 +81,25 @@ class ConfigBase {
 
   [[nodiscard]] virtual auto clone() const -> BasePtr = 0;
 
-  [[nodiscard]] auto loc() const -> std::string { return fmt::format("{}:{}", source, line); }
+  [[nodiscard]] auto loc() const -> std::string {
+    return fmt::format("{}:{}", source != nullptr ? std::string_view(*source) : "", line);
+  }
 
   const Type type;
 
   std::size_t line{0};
-  std::string source{};
+  Source source{};
 
  protected:
-  explicit ConfigBase(const Type in_type) : type{in_type} {}
+  explicit ConfigBase(const Type in_type) : type{in_type} { stats::nodeCreated(); }
 
-  ConfigBase(const ConfigBase&) = default;
-  ConfigBase(ConfigBase&&) = default;
+  ConfigBase(const ConfigBase& other) : type{other.type}, line{other.line}, source{other.source} {
+    stats::nodeCreated();
+  }
+  ConfigBase(ConfigBase&& other) noexcept
+      : type{other.type}, line{other.line}, source{std::move(other.source)} {
+    stats::nodeCreated();
+  }
 };
 
 // Use CRTP to add "clone" method to each class.
@@ -174,10 +198,51 @@ inline void pprint(std::ostream& os, const MapType& data, std::size_t depth) {
   }
 }
 
+/// \brief The value of a `kNumber` node, decoded once when the node is created. Integers are
+///        stored as `int64_t` if they fit (otherwise `uint64_t`), and everything else as `double`.
+using Number = std::variant<std::monostate, int64_t, uint64_t, double>;
+
+/// \brief Decodes a number from its text. A floating point `value_any` (e.g. the result of an
+///        expression) takes precedence, as the text may have been rounded.
+inline auto toNumber(std::string_view value, const std::any& value_any) -> Number {
+  if (const auto* d_val = std::any_cast<double>(&value_any)) {
+    return *d_val;
+  }
+  if (const auto* f_val = std::any_cast<float>(&value_any)) {
+    return static_cast<double>(*f_val);
+  }
+  const auto parsed = [value](auto out) -> std::optional<decltype(out)> {
+    const auto [len, ec] = details::fromChars(value, out);
+    return (ec == std::errc{} && len == value.size()) ? std::optional{out} : std::nullopt;
+  };
+  if (const auto i_val = parsed(int64_t{})) {
+    return *i_val;
+  }
+  if (const auto ui_val = parsed(uint64_t{}); ui_val && !value.starts_with('-')) {
+    return *ui_val;
+  }
+  if (const auto d_val = parsed(double{})) {
+    return *d_val;
+  }
+  return {};
+}
+
+/// \brief Removes the quotes from the text of a string value (which can only appear at either end)
+inline auto unquote(std::string_view value) -> std::string_view {
+  if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+    value.remove_prefix(1);
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
 class ConfigValue : public ConfigBaseClonable<ConfigBase, ConfigValue> {
  public:
   explicit ConfigValue(std::string value_in, Type type, std::any val = {})
-      : ConfigBaseClonable(type), value{std::move(value_in)}, value_any{std::move(val)} {};
+      : ConfigBaseClonable(type),
+        value{std::move(value_in)},
+        value_any{std::move(val)},
+        number{type == Type::kNumber ? toNumber(value, value_any) : Number{}} {};
 
   void stream(std::ostream& os) const override { os << value; }
 
@@ -185,6 +250,14 @@ class ConfigValue : public ConfigBaseClonable<ConfigBase, ConfigValue> {
 
   const std::any value_any{};
 
+  const Number number{};
+
+  /// \brief The value of a `kString` node without the quotes (empty for anything else). This is a
+  ///        view of `value`, so it is only valid for the lifetime of the node.
+  [[nodiscard]] auto unquoted() const -> std::string_view {
+    return type == Type::kString ? unquote(value) : std::string_view{};
+  }
+
   ~ConfigValue() noexcept override = default;
   auto operator=(const ConfigValue&) -> ConfigValue& = delete;
   auto operator=(ConfigValue&&) -> ConfigValue& = delete;
@@ -194,22 +267,212 @@ class ConfigValue : public ConfigBaseClonable<ConfigBase, ConfigValue> {
   ConfigValue(ConfigValue&&) = default;
 };
 
+/// \brief The elements of a list of number or boolean literals that all decode to the same type,
+///        stored contiguously instead of as one node per element. The text of the numbers is kept
+///        (back to back in a single buffer), so the list is still printed exactly as written.
+class PackedList {
+ public:
+  using Values = std::variant<std::monostate, std::vector<int64_t>, std::vector<uint64_t>,
+                              std::vector<double>, std::vector<bool>>;
+
+  /// \brief Appends `element` to the list.
+  /// \return False (leaving the list unchanged) if `element` isn't a literal of the same type as
+  ///         the rest of the elements, or is from another source.
+  auto append(const ConfigBase& element) -> bool {
+    if (!lines_.empty() && element.source != source_) {
+      return false;
+    }
+    if (!appendValue(element)) {
+      return false;
+    }
+    lines_.push_back(element.line);
+    source_ = element.source;
+    return true;
+  }
+
+  /// \brief The type of the elements (either `kNumber` or `kBoolean`)
+  [[nodiscard]] auto type() const -> Type {
+    return std::holds_alternative<std::vector<bool>>(values_) ? Type::kBoolean : Type::kNumber;
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return std::visit(
+        [](const auto& values) -> std::size_t {
+          if constexpr (std::is_same_v<std::decay_t<decltype(values)>, std::monostate>) {
+            return 0;
+          } else {
+            return values.size();
+          }
+        },
+        values_);
+  }
+
+  /// \brief The decoded elements. Holds a vector of the common type of all of the elements.
+  [[nodiscard]] auto values() const -> const Values& { return values_; }
+
+  /// \brief The text of the element at `i` (as it would be found in `ConfigValue::value`)
+  [[nodiscard]] auto text(std::size_t i) const -> std::string_view {
+    if (const auto* bools = std::get_if<std::vector<bool>>(&values_)) {
+      return bools->at(i) ? "true" : "false";
+    }
+    const auto begin = i == 0 ? 0 : ends_.at(i - 1);
+    return std::string_view(text_).substr(begin, ends_.at(i) - begin);
+  }
+
+  /// \brief The element at `i` (as it would be found in `ConfigValue::number`)
+  [[nodiscard]] auto number(std::size_t i) const -> Number {
+    return std::visit(
+        [i](const auto& values) -> Number {
+          using V = std::decay_t<decltype(values)>;
+          if constexpr (std::is_same_v<V, std::monostate> ||
+                        std::is_same_v<V, std::vector<bool>>) {
+            return {};
+          } else {
+            return values.at(i);
+          }
+        },
+        values_);
+  }
+
+  /// \brief The line of the element at `i`
+  [[nodiscard]] auto line(std::size_t i) const -> std::size_t { return lines_.at(i); }
+
+  /// \brief The source of the elements (all of them are from the same one)
+  [[nodiscard]] auto source() const -> const Source& { return source_; }
+
+  /// \brief Creates a node for the element at `i`
+  [[nodiscard]] auto node(std::size_t i) const -> ValuePtr {
+    std::any value_any{};
+    if (const auto* bools = std::get_if<std::vector<bool>>(&values_)) {
+      value_any = static_cast<bool>(bools->at(i));
+    } else if (const auto* doubles = std::get_if<std::vector<double>>(&values_)) {
+      // See `toNumber`: this keeps the decoded value identical to the original node.
+      value_any = doubles->at(i);
+    }
+    auto node = std::make_shared<ConfigValue>(std::string(text(i)), type(), std::move(value_any));
+    node->line = line(i);
+    node->source = source_;
+    return node;
+  }
+
+ private:
+  auto appendValue(const ConfigBase& element) -> bool {
+    const auto* value = dynamic_cast<const ConfigValue*>(&element);
+    if (value == nullptr) {
+      return false;
+    }
+    if (value->type == Type::kBoolean) {
+      return append<std::vector<bool>>(value->value == "true", {});
+    }
+    if (value->type != Type::kNumber) {
+      return false;
+    }
+    return std::visit(
+        [this, value](auto number) {
+          using N = decltype(number);
+          if constexpr (std::is_same_v<N, std::monostate>) {
+            return false;
+          } else {
+            return append<std::vector<N>>(number, value->value);
+          }
+        },
+        value->number);
+  }
+
+  template <typename Vector>
+  auto append(typename Vector::value_type value, std::string_view text) -> bool {
+    if (std::holds_alternative<std::monostate>(values_)) {
+      values_.emplace<Vector>();
+    }
+    auto* values = std::get_if<Vector>(&values_);
+    if (values == nullptr) {
+      return false;
+    }
+    values->push_back(value);
+    if constexpr (!std::is_same_v<Vector, std::vector<bool>>) {
+      text_.append(text);
+      ends_.push_back(text_.size());
+    }
+    return true;
+  }
+
+  Values values_{};
+  std::string text_{};
+  std::vector<std::size_t> ends_{};
+  std::vector<std::size_t> lines_{};
+  Source source_{};
+};
+
 class ConfigList : public ConfigBaseClonable<ConfigValue, ConfigList> {
  public:
   ConfigList(std::string value_in = "") : ConfigBaseClonable(std::move(value_in), Type::kList) {};
 
   void stream(std::ostream& os) const override {
     os << "[";
-    for (auto it = data.begin(); it != data.end(); it = std::next(it)) {
-      os << *it;
-      if (std::next(it) != data.end()) {
+    for (std::size_t i = 0; i < size(); ++i) {
+      if (i > 0) {
         os << ", ";
       }
+      if (packed_) {
+        os << packed_->text(i);
+      } else {
+        os << data_[i];
+      }
     }
     os << "]";
   }
 
-  std::vector<std::shared_ptr<ConfigBase>> data;
+  /// \brief Adds an element to the end of the list. Literals are packed (see `packed`) for as long
+  ///        as all of the elements can be, after which every element is stored as a node.
+  void append(BasePtr element) {
+    if (data_.empty()) {
+      auto& list = packed_ ? *packed_ : packed_.emplace();
+      if (list.append(*element)) {
+        return;
+      }
+      data_ = elements();
+      packed_.reset();
+    }
+    data_.push_back(std::move(element));
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return packed_ ? packed_->size() : data_.size();
+  }
+
+  /// \brief The elements of the list if they are all literals of the same type, otherwise nullptr
+  [[nodiscard]] auto packed() const -> const PackedList* { return packed_ ? &*packed_ : nullptr; }
+
+  /// \brief The element nodes of a list that isn't packed (see `packed`). Packed lists only hold
+  ///        literals, so anything that replaces elements (e.g. references) can skip them.
+  [[nodiscard]] auto nodes() const -> const std::vector<BasePtr>& {
+    checkUnpacked();
+    return data_;
+  }
+
+  [[nodiscard]] auto nodes() -> std::vector<BasePtr>& {
+    checkUnpacked();
+    return data_;
+  }
+
+  /// \brief Returns the element at `i`. Packed elements are turned into (new) nodes on demand, so
+  ///        prefer reading them through `packed` where possible.
+  [[nodiscard]] auto at(std::size_t i) const -> BasePtr {
+    return packed_ ? packed_->node(i) : data_.at(i);
+  }
+
+  /// \brief Returns all of the elements (see `at`)
+  [[nodiscard]] auto elements() const -> std::vector<BasePtr> {
+    if (!packed_) {
+      return data_;
+    }
+    std::vector<BasePtr> nodes;
+    nodes.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+      nodes.push_back(packed_->node(i));
+    }
+    return nodes;
+  }
 
   Type list_element_type{Type::kUnknown};
 
@@ -220,18 +483,32 @@ class ConfigList : public ConfigBaseClonable<ConfigValue, ConfigList> {
  protected:
   ConfigList(const ConfigList&) = default;
   ConfigList(ConfigList&&) = default;
+
+ private:
+  void checkUnpacked() const {
+    if (packed_) {
+      THROW_EXCEPTION(InvalidStateException, "The elements of the list at {} are packed.", loc());
+    }
+  }
+
+  /// The elements of the list, unless they are packed
+  std::vector<BasePtr> data_;
+
+  /// The elements of the list if they are all literals of the same type (`data_` is empty then)
+  std::optional<PackedList> packed_;
 };
 
 class ConfigValueLookup : public ConfigBaseClonable<ConfigBase, ConfigValueLookup> {
  public:
-  explicit ConfigValueLookup(const std::string& var_ref)
-      : ConfigBaseClonable(Type::kValueLookup), keys{utils::split(var_ref, '.')} {};
+  explicit ConfigValueLookup(std::string var_ref)
+      : ConfigBaseClonable(Type::kValueLookup), var_ref_{std::move(var_ref)} {};
 
   void stream(std::ostream& os) const override { os << "$(" << var() << ")"; }
 
-  const std::vector<std::string> keys{};
+  /// \brief The parts of the referenced key (split lazily, see `utils::splitView`)
+  [[nodiscard]] auto keys() const -> utils::SplitView { return utils::splitView(var_ref_); }
 
-  [[nodiscard]] auto var() const -> std::string { return utils::join(keys, "."); }
+  [[nodiscard]] auto var() const -> const std::string& { return var_ref_; }
 
   ~ConfigValueLookup() noexcept override = default;
   auto operator=(const ConfigValueLookup&) -> ConfigValueLookup& = delete;
@@ -240,6 +517,9 @@ class ConfigValueLookup : public ConfigBaseClonable<ConfigBase, ConfigValueLooku
  protected:
   ConfigValueLookup(const ConfigValueLookup&) = default;
   ConfigValueLookup(ConfigValueLookup&&) = default;
+
+ private:
+  std::string var_ref_;
 };
 
 // ConfigExpression is a special "value" type. We want the same interface as ConfigValue because it
@@ -247,12 +527,91 @@ class ConfigValueLookup : public ConfigBaseClonable<ConfigBase, ConfigValueLooku
 // strings
 class ConfigExpression : public ConfigBaseClonable<ConfigValue, ConfigExpression> {
  public:
+  /// \brief A part of an expression. Concatenating the text of all of the tokens (with the
+  ///        `$(...)` restored around the value lookups) reproduces the original expression.
+  struct Token {
+    enum class Kind : uint8_t { kLiteral, kVar, kValueLookup };
+
+    Kind kind{Kind::kLiteral};
+    /// The literal text, the name of the var (always as `$VAR`) or the contents of the value lookup
+    std::string text{};
+    /// Only used by `kVar`. True if the var is written as `${VAR}`
+    bool braced{false};
+    /// Only used by `kValueLookup`. The contents split into literal text & vars (empty if the value
+    /// lookup doesn't contain any vars)
+    std::vector<Token> parts{};
+  };
+
   explicit ConfigExpression(std::string expression_in, CfgMap val_lookups)
       : ConfigBaseClonable(std::move(expression_in), Type::kExpression),
-        value_lookups{std::move(val_lookups)} {};
+        value_lookups{std::move(val_lookups)},
+        tokens{tokenize(value)} {};
 
   CfgMap value_lookups{};
 
+  /// The expression split into literal text, vars & value lookups.
+  const std::vector<Token> tokens{};
+
+  /// The compiled expression (see `math::compile`). This is compiled on first use and is shared by
+  /// all copies of this expression.
+  std::shared_ptr<const math::Program> program{};
+
+  /// \brief Checks if the expression contains any vars (including within value lookups)
+  [[nodiscard]] auto hasVars() const -> bool {
+    return std::any_of(tokens.begin(), tokens.end(), [](const Token& t) {
+      return t.kind == Token::Kind::kVar ||
+             (t.kind == Token::Kind::kValueLookup && t.text.find('$') != std::string::npos);
+    });
+  }
+
+  /// \brief Splits an expression (that has already been validated by the grammar) into tokens.
+  ///        A `$` can only start a `VAR` or a `VALUE_LOOKUP`, so everything else is literal text.
+  static auto tokenize(std::string_view expression) -> std::vector<Token> {
+    const auto is_var_char = [](char c) {
+      return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    };
+    std::vector<Token> out;
+    std::size_t start = 0;
+    for (auto pos = expression.find('$'); pos != std::string_view::npos;
+         pos = expression.find('$', start)) {
+      if (pos > start) {
+        out.push_back({Token::Kind::kLiteral, std::string(expression.substr(start, pos - start))});
+      }
+      const auto next = pos + 1 < expression.size() ? expression[pos + 1] : '\0';
+      const auto end = next == '(' ? expression.find(')', pos)
+                       : next == '{' ? expression.find('}', pos)
+                                     : pos;
+      if (end == std::string_view::npos) {
+        // Not a valid expression. Leave the remainder as is.
+        start = pos;
+        break;
+      }
+      if (next == '(') {
+        auto& lookup = out.emplace_back(Token{
+            Token::Kind::kValueLookup, std::string(expression.substr(pos + 2, end - pos - 2))});
+        if (lookup.text.find('$') != std::string::npos) {
+          lookup.parts = tokenize(lookup.text);
+        }
+        start = end + 1;
+      } else if (next == '{') {
+        out.push_back({Token::Kind::kVar,
+                       std::string("$").append(expression.substr(pos + 2, end - pos - 2)), true});
+        start = end + 1;
+      } else {
+        auto var_end = end + 1;
+        while (var_end < expression.size() && is_var_char(expression[var_end])) {
+          ++var_end;
+        }
+        out.push_back({Token::Kind::kVar, std::string(expression.substr(pos, var_end - pos))});
+        start = var_end;
+      }
+    }
+    if (start < expression.size()) {
+      out.push_back({Token::Kind::kLiteral, std::string(expression.substr(start))});
+    }
+    return out;
+  }
+
   ~ConfigExpression() noexcept override = default;
   auto operator=(const ConfigExpression&) -> ConfigExpression& = delete;
   auto operator=(ConfigExpression&&) -> ConfigExpression& = delete;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tao/pegtl.hpp>
+
+namespace flexi_cfg::config {
+namespace peg = TAO_PEGTL_NAMESPACE;
+
+/// \brief The contents of every file read during a parse. Each file is read once (memory mapped,
+///        where `peg::file_input` supports it) and kept for the life of the table, so the parser
+///        and any error messages produced afterwards all share the same copy. The names of the
+///        sources of the nodes are kept here as well. All methods are thread-safe.
+class FileTable {
+ public:
+  /// \brief The contents of a file, along with the name used for it in parse positions
+  struct File {
+    std::string_view contents;
+    std::string source;
+
+    /// \brief A parse input over the contents of the file (which doesn't copy them)
+    [[nodiscard]] auto input() const -> peg::memory_input<> {
+      return peg::memory_input<>(contents.data(), contents.size(), source);
+    }
+  };
+
+  /// \brief Reads the file (unless it has already been read)
+  /// \throw std::system_error if the file can't be read
+  auto open(const std::filesystem::path& path) -> File {
+    const auto source = path.string();
+    const std::lock_guard lock(mutex_);
+    auto it = files_.find(source);
+    if (it == files_.end()) {
+      it = files_.emplace(source, std::make_unique<peg::file_input<>>(path)).first;
+    }
+    return file(*it);
+  }
+
+  /// \brief Finds a file that has already been read (e.g. the source of a parse error)
+  [[nodiscard]] auto find(std::string_view source) const -> std::optional<File> {
+    const std::lock_guard lock(mutex_);
+    const auto it = files_.find(source);
+    return it != files_.end() ? std::optional<File>{file(*it)} : std::nullopt;
+  }
+
+  /// \brief The single, shared copy of the name of a source (e.g. a file or string) that the nodes
+  ///        parsed from it refer to
+  auto source(std::string_view name) -> std::shared_ptr<const std::string> {
+    const std::lock_guard lock(mutex_);
+    auto it = sources_.find(name);
+    if (it == sources_.end()) {
+      auto shared = std::make_shared<const std::string>(name);
+      const std::string_view key = *shared;
+      it = sources_.emplace(key, std::move(shared)).first;
+    }
+    return it->second;
+  }
+
+ private:
+  using Files = std::map<std::string, std::unique_ptr<peg::file_input<>>, std::less<>>;
+
+  static auto file(const Files::value_type& entry) -> File {
+    const auto& in = *entry.second;
+    return {{in.begin(), static_cast<std::size_t>(in.end() - in.begin())}, entry.first};
+  }
+
+  mutable std::mutex mutex_;
+  Files files_;
+  // The keys refer to the (never modified) names held by the values.
+  std::map<std::string_view, std::shared_ptr<const std::string>> sources_;
+};
+
+}  // namespace flexi_cfg::config
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flexi_cfg/config/classes.h"
+
+namespace flexi_cfg::config::types {
+
+/// \brief A compact, read-only copy of a fully resolved config tree.
+///
+/// All nodes are stored by value in a single array and are referred to by index. The children of
+/// each struct or list are stored contiguously. The type of each node is inspected once (when the
+/// tree is frozen), so reading from it doesn't require any `dynamic_pointer_cast`s or reference
+/// counting. Every node (except list elements) is also indexed by its full (dot-separated) key, so
+/// finding a node is a single hash lookup.
+///
+/// The keys, paths & values are copied into an arena owned by the frozen copy (i.e. shared by the
+/// readers of it), so they aren't allocated one by one, and are all released together.
+class FrozenCfg {
+ public:
+  using Index = uint32_t;
+
+  struct Node {
+    Type type{Type::kUnknown};
+    /// For struct-likes & lists, the index of the first child. Otherwise the index of the value.
+    Index first{0};
+    /// The number of children (zero for values)
+    Index size{0};
+  };
+
+  /// The index of the root struct.
+  static constexpr Index root{0};
+
+  /// \brief Freezes `cfg`. The tree is kept alive (but never modified) by the frozen copy.
+  explicit FrozenCfg(std::shared_ptr<const CfgMap> cfg);
+
+  /// \brief Copies the frozen tree. The strings are copied into the arena of the copy, and the key
+  ///        index (which refers to them) is rebuilt.
+  FrozenCfg(const FrozenCfg& other);
+  FrozenCfg(FrozenCfg&&) noexcept = default;
+  auto operator=(const FrozenCfg& other) -> FrozenCfg&;
+  auto operator=(FrozenCfg&&) noexcept -> FrozenCfg& = default;
+  ~FrozenCfg() = default;
+
+  [[nodiscard]] auto size() const -> std::size_t { return nodes_.size(); }
+
+  [[nodiscard]] auto type(Index idx) const -> Type { return nodes_[idx].type; }
+
+  [[nodiscard]] auto isStructLike(Index idx) const -> bool;
+
+  /// \brief The key of the node within its parent struct (empty for list elements & the root)
+  [[nodiscard]] auto key(Index idx) const -> std::string_view { return keys_[idx]; }
+
+  /// \brief The text of a value (empty for structs & lists). Strings are stored without their
+  ///        quotes.
+  [[nodiscard]] auto value(Index idx) const -> std::string_view;
+
+  /// \brief The decoded value of a number (empty for anything else)
+  [[nodiscard]] auto number(Index idx) const -> const Number&;
+
+  /// \brief The indices of the children of a struct or list (in order)
+  [[nodiscard]] auto children(Index idx) const {
+    const auto& node = nodes_[idx];
+    const bool has_children = isStructLike(idx) || node.type == Type::kList;
+    const auto first = has_children ? node.first : Index{0};
+    return std::views::iota(first, first + node.size);
+  }
+
+  /// \brief The full key of the node (empty for list elements & the root)
+  [[nodiscard]] auto path(Index idx) const -> std::string_view { return paths_[idx]; }
+
+  /// \brief The map of a struct-like node (within the tree that was frozen). This doesn't copy
+  ///        the map, and shares ownership of the tree.
+  [[nodiscard]] auto map(Index idx) const -> std::shared_ptr<const CfgMap>;
+
+  /// \brief Finds the child of a struct with the given key
+  [[nodiscard]] auto child(Index parent, std::string_view key) const -> std::optional<Index>;
+
+  /// \brief Finds the node for the given (dot-separated) key, relative to `parent`. This doesn't
+  ///        allocate.
+  /// \return The index of the node, or `std::nullopt` if it doesn't exist
+  [[nodiscard]] auto find(Index parent, std::string_view key) const -> std::optional<Index>;
+
+  /// \brief Finds the node for the given (split) key, relative to `parent`
+  /// \return The index of the node, or `std::nullopt` if it doesn't exist
+  [[nodiscard]] auto find(Index parent, const std::vector<std::string>& keys) const
+      -> std::optional<Index>;
+
+  /// \brief Same as `find`, but throws (the same exceptions as `helpers::getConfigValue`) if the
+  ///        key doesn't exist
+  [[nodiscard]] auto get(Index parent, std::string_view key) const -> Index;
+
+  [[nodiscard]] auto get(Index parent, const std::vector<std::string>& keys) const -> Index;
+
+  /// \brief Formats the node for use in error messages
+  [[nodiscard]] auto str(Index idx) const -> std::string;
+
+ private:
+  /// \brief Indexes every node by its full key. This must be called once `paths_` is complete.
+  void buildIndex();
+
+  /// \brief Copies `str` into the arena
+  auto store(std::string_view str) -> std::string_view;
+
+  /// \brief Joins `prefix` & `key` (as `utils::makeName` does) in the arena
+  auto store(std::string_view prefix, std::string_view key) -> std::string_view;
+
+  void freeze(Index idx, const BasePtr& cfg);
+
+  void freezeChildren(Index idx, const CfgMap& cfg);
+
+  /// \brief A full key split into the key of a struct & a key relative to that struct. This allows
+  ///        looking up keys relative to any struct without joining the strings.
+  struct Path {
+    std::string_view prefix;
+    std::string_view key;
+  };
+
+  struct PathHash {
+    using is_transparent = void;
+    auto operator()(std::string_view path) const -> std::size_t;
+    auto operator()(const Path& path) const -> std::size_t;
+  };
+
+  struct PathEqual {
+    using is_transparent = void;
+    auto operator()(std::string_view lhs, std::string_view rhs) const -> bool { return lhs == rhs; }
+    auto operator()(const Path& lhs, std::string_view rhs) const -> bool;
+    auto operator()(std::string_view lhs, const Path& rhs) const -> bool {
+      return (*this)(rhs, lhs);
+    }
+  };
+
+  std::shared_ptr<const CfgMap> cfg_{};
+  // Holds the strings that `keys_`, `paths_` & `values_` refer to. It's kept by pointer so that
+  // they remain valid when the frozen copy is moved.
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_{
+      std::make_unique<std::pmr::monotonic_buffer_resource>()};
+  std::vector<Node> nodes_{};
+  // The map of each struct-like node (within `cfg_`), or nullptr for anything else
+  std::vector<const CfgMap*> maps_{};
+  std::vector<std::string_view> keys_{};
+  std::vector<std::string_view> paths_{};
+  // Refers to the same strings as `paths_`
+  std::unordered_map<std::string_view, Index, PathHash, PathEqual> index_{};
+  std::vector<std::string_view> values_{};
+  std::vector<Number> numbers_{};
+};
+
+}  // namespace flexi_cfg::config::types
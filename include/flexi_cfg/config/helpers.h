@@ -2,8 +2,10 @@
 
 #include <memory>
 #include <span>
+#include <string_view>
 
 #include "flexi_cfg/config/classes.h"
+#include "flexi_cfg/utils.h"
 
 namespace flexi_cfg::config {
 // Create a set of traits for acceptable containers for holding elements of type `kList`. We define
@@ -44,6 +46,13 @@ auto checkForErrors(const types::CfgMap& cfg1, const types::CfgMap& cfg2, const
  * key/value pairs from cfg2. */
 auto mergeNestedMaps(const types::CfgMap& cfg1, const types::CfgMap& cfg2) -> types::CfgMap;
 
+/// \brief Merges all of the maps (e.g. the results of each included file) into a single map, in
+///        order. This is equivalent to folding the maps with `mergeNestedMaps`, but is done in a
+///        single pass over each map, in place. The contents of `in` are consumed.
+/// \param[in] in - The maps to merge
+/// \return The merged map
+auto mergeNested(std::vector<types::CfgMap>&& in) -> types::CfgMap;
+
 auto structFromReference(std::shared_ptr<types::ConfigReference>& ref,
                          const std::shared_ptr<types::ConfigProto>& proto)
     -> std::shared_ptr<types::ConfigStruct>;
@@ -56,15 +65,25 @@ auto replaceVarInStr(std::string input, const types::RefMap& ref_vars)
 /// \param[in] ref_vars - All of the available 'ConfigVar's in the reference
 void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars);
 
+/// \brief Finds the struct-like object containing the last of `keys` (i.e. the parent of the value
+///        they refer to), or `nullptr` if there is only a single key. Lookups are done in place, so
+///        nothing is allocated unless one of the keys can't be found.
 auto getNestedConfig(const types::CfgMap& cfg, const std::vector<std::string>& keys)
     -> std::shared_ptr<types::ConfigStructLike>;
 
-auto getNestedConfig(const types::CfgMap& cfg, const std::string& flat_key)
+auto getNestedConfig(const types::CfgMap& cfg, const utils::SplitView& keys)
+    -> std::shared_ptr<types::ConfigStructLike>;
+
+auto getNestedConfig(const types::CfgMap& cfg, std::string_view flat_key)
     -> std::shared_ptr<types::ConfigStructLike>;
 
+/// \brief Finds the value referred to by `keys`. As with `getNestedConfig`, nothing is allocated
+///        unless one of the keys can't be found.
 auto getConfigValue(const types::CfgMap& cfg, const std::vector<std::string>& keys)
     -> types::BasePtr;
 
+auto getConfigValue(const types::CfgMap& cfg, const utils::SplitView& keys) -> types::BasePtr;
+
 auto getConfigValue(const types::CfgMap& cfg, const std::shared_ptr<types::ConfigValueLookup>& var)
     -> types::BasePtr;
 
@@ -83,7 +102,7 @@ auto unflatten(std::span<std::string> keys, const types::CfgMap& cfg) -> types::
 /// \param[in] flat_key - The dot-separated key
 /// \param[in/out] cfg - The root of the existing data structure
 /// \param[in] depth - The current depth level of the data structure
-void unflatten(const std::string& flat_key, types::CfgMap& cfg, std::size_t depth = 0);
+void unflatten(std::string_view flat_key, types::CfgMap& cfg, std::size_t depth = 0);
 
 void cleanupConfig(types::CfgMap& cfg, std::size_t depth = 0);
 
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace flexi_cfg::details {
+
+/// \brief The outcome of `fromChars`
+struct FromCharsResult {
+  /// The number of characters consumed (including any whitespace, sign and base prefix)
+  std::size_t processed{0};
+  /// `std::errc{}` on success, `std::errc::invalid_argument` if no number was found or
+  /// `std::errc::result_out_of_range` if the number doesn't fit in the requested type.
+  std::errc ec{};
+};
+
+namespace internal {
+inline auto hasHexPrefix(std::string_view str) -> bool {
+  return str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X') &&
+         std::isxdigit(static_cast<unsigned char>(str[2])) != 0;
+}
+}  // namespace internal
+
+/// \brief Converts the leading part of `str` to a number without allocating or throwing. The
+///        accepted syntax matches the `std::sto*` family (with `base = 0` for integers): leading
+///        whitespace, an optional sign and an optional `0x` (hex) or `0` (octal) prefix. It is
+///        locale independent.
+/// \param[in] str The text to convert
+/// \param[out] value The result (only written on success)
+/// \return The number of characters processed & the error (if any)
+template <typename T>
+  requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+auto fromChars(std::string_view str, T& value) -> FromCharsResult {
+  std::size_t pos{0};
+  while (pos < str.size() && std::isspace(static_cast<unsigned char>(str[pos])) != 0) {
+    ++pos;
+  }
+  bool negative{false};
+  if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+    negative = str[pos] == '-';
+    ++pos;
+  }
+  const bool hex = internal::hasHexPrefix(str.substr(pos));
+  if (hex) {
+    pos += 2;
+  }
+  const auto* first = str.data() + pos;
+  const auto* last = str.data() + str.size();
+
+  if constexpr (std::is_floating_point_v<T>) {
+    // NOTE: `std::from_chars` doesn't accept a '+' or the "0x" prefix, which is why the sign &
+    // prefix are consumed above. It does accept a '-', so a second sign has to be rejected here.
+    if (first != last && *first == '-') {
+      return {0, std::errc::invalid_argument};
+    }
+    T magnitude{};
+    const auto [ptr, ec] = std::from_chars(
+        first, last, magnitude, hex ? std::chars_format::hex : std::chars_format::general);
+    if (ec == std::errc::invalid_argument) {
+      return {0, std::errc::invalid_argument};
+    }
+    const auto processed = static_cast<std::size_t>(ptr - str.data());
+    if (ec != std::errc{}) {
+      return {processed, ec};
+    }
+    value = negative ? -magnitude : magnitude;
+    return {processed, {}};
+  } else {
+    using Unsigned = std::make_unsigned_t<T>;
+    const int base = hex ? 16 : (first != last && *first == '0' ? 8 : 10);
+    Unsigned magnitude{};
+    const auto [ptr, ec] = std::from_chars(first, last, magnitude, base);
+    if (ec == std::errc::invalid_argument) {
+      return {0, std::errc::invalid_argument};
+    }
+    const auto processed = static_cast<std::size_t>(ptr - str.data());
+    if (ec != std::errc{}) {
+      return {processed, ec};
+    }
+    if constexpr (std::is_signed_v<T>) {
+      const auto limit =
+          static_cast<Unsigned>(std::numeric_limits<T>::max()) + static_cast<Unsigned>(negative);
+      if (magnitude > limit) {
+        return {processed, std::errc::result_out_of_range};
+      }
+      // NOTE: Negating in the unsigned type avoids overflow for the most negative value.
+      value = static_cast<T>(negative ? Unsigned{0} - magnitude : magnitude);
+    } else {
+      // Like `std::stoull`, a negative number wraps around.
+      value = negative ? static_cast<T>(T{0} - magnitude) : magnitude;
+    }
+    return {processed, {}};
+  }
+}
+
+}  // namespace flexi_cfg::details
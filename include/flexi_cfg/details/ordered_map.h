@@ -1,14 +1,21 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <concepts>
-#include <deque>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
-#include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -48,307 +55,276 @@ struct string_hash : public std::hash<std::string_view> {
   }
 };
 
+// A hash map that iterates over its elements in the order they were inserted.
+//
+// The elements are stored contiguously (in insertion order) in `entries_`, and are found through an
+// open-addressing (linear probing) table of indices into `entries_`. Iterating is a walk over the
+// dense array, and finding a key is a single probe sequence. Erasing an element leaves a tombstone
+// in both arrays (so erasing is O(1) and doesn't move any other element). The tombstones are
+// dropped whenever the table is rebuilt.
+//
+// NOTE: Unlike `std::unordered_map`, inserting an element may invalidate references & iterators to
+// the other elements (as with `std::vector`). Erasing only invalidates those to the erased element,
+// unless the tombstones are cleared out (which happens once more than half the entries are erased).
 template <typename Key, typename T, typename Hash = std::hash<Key>, typename Pred = std::equal_to<>,
           typename Alloc = std::allocator<std::pair<const Key, T>>>
 class ordered_map {
-  using Map = std::unordered_map<Key, T, Hash, Pred, Alloc>;
-  using OrderedKeys = std::vector<Key>;
-
-  Map map_;
-  OrderedKeys keys_;
+ public:
+  using key_type = Key;
+  using value_type = std::pair<const Key, T>;
+  using mapped_type = T;
+  using hasher = Hash;
+  using key_equal = Pred;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+
+ private:
+  // An erased element is left in place as an empty entry (a tombstone).
+  using Entry = std::optional<value_type>;
+  using EntryAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+  using Entries = std::vector<Entry, EntryAlloc>;
+
+  // A slot of the index table, which refers to an entry (or is empty or a tombstone). Part of the
+  // hash is kept as well, so that most mismatches are rejected without comparing the keys.
+  struct Slot {
+    std::uint32_t entry{kEmpty};
+    std::uint32_t hash{0};
+  };
+  static constexpr std::uint32_t kEmpty{std::numeric_limits<std::uint32_t>::max()};
+  static constexpr std::uint32_t kTombstone{kEmpty - 1};
+  static constexpr size_type kMinSlots{8};
+  static constexpr size_type kNotFound{std::numeric_limits<size_type>::max()};
+
+  Entries entries_;
+  std::vector<Slot> slots_;
+  size_type size_{0};
+  // The number of slots that aren't empty (including tombstones).
+  size_type used_slots_{0};
+  [[no_unique_address]] Hash hash_{};
+  [[no_unique_address]] Pred pred_{};
 
  public:
-  using key_type = typename Map::key_type;
-  using value_type = typename Map::value_type;
-  using mapped_type = typename Map::mapped_type;
-  using hasher = typename Map::hasher;
-  using key_equal = typename Map::key_equal;
-  using allocator_type = typename Map::allocator_type;
-  using node_type = typename Map::node_type;
+  // A node handle holding an element that was extracted from the map (see `extract`).
+  class node_type {
+   public:
+    node_type() = default;
 
-  // Iterator related typedefs
-  using size_type = typename Map::size_type;
+    [[nodiscard]] bool empty() const noexcept { return !value_.has_value(); }
+    explicit operator bool() const noexcept { return value_.has_value(); }
 
-  ordered_map() = default;
+    Key& key() { return value_->first; }
+    const Key& key() const { return value_->first; }
+    T& mapped() { return value_->second; }
+    const T& mapped() const { return value_->second; }
 
-  // explicit ordered_map(size_type n) : map_(n), keys_(n){};
+   private:
+    friend class ordered_map;
+    explicit node_type(std::pair<Key, T>&& value) : value_{std::move(value)} {}
+
+    std::optional<std::pair<Key, T>> value_;
+  };
+
+  ordered_map() = default;
 
   template <typename InputIterator>
-  ordered_map(InputIterator first, InputIterator last) : map_(first, last) {
-    std::transform(first, last, std::back_inserter(keys_),
-                   [](const auto& value) { return value.first; });
+  ordered_map(InputIterator first, InputIterator last) {
+    insert(first, last);
   }
 
   // Copy constructor
   ordered_map(const ordered_map&) = default;
 
   // Move constructor
-  ordered_map(ordered_map&&) = default;
+  ordered_map(ordered_map&& other) noexcept
+      : entries_(std::move(other.entries_)),
+        slots_(std::move(other.slots_)),
+        size_(std::exchange(other.size_, 0)),
+        used_slots_(std::exchange(other.used_slots_, 0)),
+        hash_(std::move(other.hash_)),
+        pred_(std::move(other.pred_)) {
+    other.entries_.clear();
+    other.slots_.clear();
+  }
 
   // Constructor (1)
-  explicit ordered_map(const Pred& /*comp*/, const Alloc& alloc = Alloc()) : map_(alloc) {}
+  explicit ordered_map(const Pred& comp, const Alloc& alloc = Alloc())
+      : entries_(EntryAlloc(alloc)), pred_(comp) {}
 
   // Constructor (2)
-  explicit ordered_map(const Alloc& alloc) : map_(alloc) {}
+  explicit ordered_map(const Alloc& alloc) : entries_(EntryAlloc(alloc)) {}
 
   // Constructor (3)
   template <typename InputIterator>
-  ordered_map(InputIterator first, InputIterator last, const Pred& /*comp*/,
+  ordered_map(InputIterator first, InputIterator last, const Pred& comp,
               const Alloc& alloc = Alloc())
-      : map_(first, last, 0, Hash{}, Pred{}, alloc) {
-    std::transform(first, last, std::back_inserter(keys_),
-                   [](const auto& value) { return value.first; });
+      : entries_(EntryAlloc(alloc)), pred_(comp) {
+    insert(first, last);
   }
 
   // Constructor (4)
-  ordered_map(std::initializer_list<value_type> init, const Pred& /*comp*/,
+  ordered_map(std::initializer_list<value_type> init, const Pred& comp,
               const Alloc& alloc = Alloc())
-      : map_(init, 0, Hash{}, Pred{}, alloc) {
-    std::transform(std::begin(init), std::end(init), std::back_inserter(keys_),
-                   [](const value_type& value) { return value.first; });
+      : entries_(EntryAlloc(alloc)), pred_(comp) {
+    insert(init.begin(), init.end());
   }
 
+  ordered_map(std::initializer_list<value_type> l) { insert(l.begin(), l.end()); }
+
+  ~ordered_map() = default;
+
   // Copy assignment operator
-  ordered_map& operator=(const ordered_map&) = default;
+  // NOTE: The keys are const, so the elements can't be assigned to. Copy them into a new map.
+  ordered_map& operator=(const ordered_map& other) {
+    if (this != &other) {
+      ordered_map copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
 
   // Move assignment operator
-  ordered_map& operator=(ordered_map&&) = default;
-
-  ordered_map(std::initializer_list<value_type> l) : map_(l) {
-    std::transform(std::begin(l), std::end(l), std::back_inserter(keys_),
-                   [](const value_type& value) { return value.first; });
+  ordered_map& operator=(ordered_map&& other) noexcept {
+    if (this != &other) {
+      entries_ = std::move(other.entries_);
+      slots_ = std::move(other.slots_);
+      size_ = std::exchange(other.size_, 0);
+      used_slots_ = std::exchange(other.used_slots_, 0);
+      hash_ = std::move(other.hash_);
+      pred_ = std::move(other.pred_);
+      other.entries_.clear();
+      other.slots_.clear();
+    }
+    return *this;
   }
 
   // List assignment operator
   ordered_map& operator=(std::initializer_list<value_type> l) {
-    map_ = l;
-    keys_.clear();
-    std::transform(std::begin(l), std::end(l), std::back_inserter(keys_),
-                   [](const value_type& value) { return value.first; });
+    clear();
+    insert(l.begin(), l.end());
     return *this;
   }
 
-  allocator_type get_allocator() const noexcept { return map_.get_allocator(); }
+  allocator_type get_allocator() const noexcept { return allocator_type(entries_.get_allocator()); }
 
-  [[nodiscard]] bool empty() const noexcept { return map_.empty(); }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
 
-  [[nodiscard]] size_type size() const noexcept { return keys_.size(); }
+  [[nodiscard]] size_type size() const noexcept { return size_; }
 
   [[nodiscard]] size_type max_size() const noexcept {
-    return std::min(map_.max_size(), keys_.max_size());
+    return std::min<size_type>(entries_.max_size(), kTombstone);
   }
 
-  // NOTE: Forward declare const_iterator_ so that iterator_base can be a friend of it.
-  class const_iterator_;
-
-  // Custom iterator for the ordered_map object.
-  // This iterator should iterate over the keys in the order they were inserted
-  template <typename MapType, typename OrderedKeysType>
+  // An iterator is a pointer into the dense array of entries. Incrementing (or decrementing) it
+  // skips over any tombstones, so it also knows where the array begins & ends.
+  template <bool IsConst>
   class iterator_base {
+    using EntryType = std::conditional_t<IsConst, const Entry, Entry>;
+
    public:
     using iterator_category = std::bidirectional_iterator_tag;
-    using value_type = typename MapType::value_type;
+    using value_type = typename ordered_map::value_type;
     using difference_type = std::ptrdiff_t;
-    using pointer = value_type*;
-    using reference = value_type&;
-
-    iterator_base(MapType* map, OrderedKeysType* keys, size_type index)
-        : map_(map), keys_(keys), index_(index) {
-      // Check that the offset is within bounds
-      if (index_ > keys_->size()) {  // index_ can be keys_->size() for end()
-        throw std::out_of_range("Index out of range");
-      }
-      update_key_from_index();
-    }
+    using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+    using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
 
     iterator_base() = default;
 
-    bool operator==(const iterator_base& other) const { return index_ == other.index_; }
-    bool operator!=(const iterator_base& other) const { return index_ != other.index_; }
-
-    friend class const_iterator_;
-
-   protected:
-    MapType* map_{nullptr};
-    OrderedKeysType* keys_{nullptr};
-    size_type index_{0};
-    std::optional<typename OrderedKeysType::value_type> key_;
-
-    void update_key_from_index() {
-      if (index_ < keys_->size()) {  // Valid for dereferencing
-        key_ = (*keys_)[index_];
-      } else {
-        key_ = std::nullopt;  // For end() or other non-dereferenceable states
-      }
-    }
-  };
-
-  class iterator_ : public iterator_base<Map, OrderedKeys> {
-   public:
-    using Base = iterator_base<Map, OrderedKeys>;
-    using reference = typename Base::reference;
-    using pointer = typename Base::pointer;
-
-    friend class const_iterator_;
-
-    iterator_(Map* map, OrderedKeys* keys, size_type index) : Base(map, keys, index) {
-      this->update_key_from_index();
-    }
+    // Converting constructor from iterator to const_iterator
+    template <bool OtherConst>
+      requires(IsConst && !OtherConst)
+    iterator_base(const iterator_base<OtherConst>& other)  // NOLINT(google-explicit-constructor)
+        : pos_(other.pos_), first_(other.first_), last_(other.last_) {}
 
-    iterator_() = default;
+    reference operator*() const { return **pos_; }
+    pointer operator->() const { return &**pos_; }
 
-    reference operator*() const {
-      // Precondition: Iterator is dereferenceable (key_ has a value).
-      // Calling .value() on a std::nullopt will throw std::bad_optional_access,
-      // which is acceptable for UB (dereferencing end()).
-      return *this->map_->find(this->key_.value());
-    }
-    pointer operator->() const {
-      // Precondition: Iterator is dereferenceable.
-      return &(*this->map_->find(this->key_.value()));
+    template <bool OtherConst>
+    bool operator==(const iterator_base<OtherConst>& other) const {
+      return pos_ == other.pos_;
     }
 
     // Prefix increment
-    iterator_& operator++() {
-      ++this->index_;
-      this->update_key_from_index();
+    iterator_base& operator++() {
+      do {
+        ++pos_;
+      } while (pos_ != last_ && !pos_->has_value());
       return *this;
     }
 
     // Postfix increment
-    iterator_ operator++(int) {
+    iterator_base operator++(int) {
       auto tmp = *this;
-      ++this->index_;
-      this->update_key_from_index();
+      ++*this;
       return tmp;
     }
 
-    iterator_& operator--() {
-      --this->index_;
-      this->update_key_from_index();
+    iterator_base& operator--() {
+      do {
+        --pos_;
+      } while (pos_ != first_ && !pos_->has_value());
       return *this;
     }
 
-    iterator_ operator--(int) {
+    iterator_base operator--(int) {
       auto tmp = *this;
-      --this->index_;
-      this->update_key_from_index();
+      --*this;
       return tmp;
     }
 
     template <std::integral I>
-    iterator_ operator+(I i) {
-      return {this->map_, this->keys_, this->index_ + i};
+    iterator_base operator+(I i) const {
+      auto tmp = *this;
+      return tmp += i;
     }
 
     template <std::integral I>
-    iterator_ operator-(I i) {
-      return {this->map_, this->keys_, this->index_ - i};
+    iterator_base operator-(I i) const {
+      auto tmp = *this;
+      return tmp -= i;
     }
 
     template <std::integral I>
-    iterator_& operator+=(I i) {
-      this->index_ += i;
-      this->update_key_from_index();
+    iterator_base& operator+=(I i) {
+      if constexpr (std::is_signed_v<I>) {
+        if (i < 0) {
+          return *this -= -static_cast<difference_type>(i);
+        }
+      }
+      for (; i > 0; --i) {
+        ++*this;
+      }
       return *this;
     }
 
     template <std::integral I>
-    iterator_& operator-=(I i) {
-      this->index_ -= i;
-      this->update_key_from_index();
-      return *this;
-    }
-  };
-
-  // Custom iterator for the ordered_map object.
-  // This iterator should iterate over the keys in the order they were inserted
-  class const_iterator_ : public iterator_base<const Map, const OrderedKeys> {
-   public:
-    using Base = iterator_base<const Map, const OrderedKeys>;
-    using reference = typename Map::value_type const&;
-    using pointer = typename Map::value_type const*;
-
-    friend class iterator_;
-    friend class iterator_base<const Map, const OrderedKeys>;
-
-    const_iterator_(const Map* map, const OrderedKeys* keys, size_type index)
-        : Base(map, keys, index) {
-      this->update_key_from_index();
-    }
-
-    // Converting constructor from iterator_ to const_iterator_
-    const_iterator_(const iterator_& other) : Base(other.map_, other.keys_, other.index_) {
-      this->update_key_from_index();
-    }
-
-    const_iterator_() = default;
-
-    reference operator*() const {
-      // Precondition: Iterator is dereferenceable.
-      return *this->map_->find(this->key_.value());
-    }
-    pointer operator->() const {
-      // Precondition: Iterator is dereferenceable.
-      return &(*this->map_->find(this->key_.value()));
-    }
-
-    // Prefix increment
-    const_iterator_& operator++() {
-      ++this->index_;
-      this->update_key_from_index();
-      return *this;
-    }
-
-    // Postfix increment
-    const_iterator_ operator++(int) {
-      auto tmp = *this;
-      ++this->index_;
-      this->update_key_from_index();
-      return tmp;
-    }
-
-    const_iterator_& operator--() {
-      --this->index_;
-      this->update_key_from_index();
+    iterator_base& operator-=(I i) {
+      if constexpr (std::is_signed_v<I>) {
+        if (i < 0) {
+          return *this += -static_cast<difference_type>(i);
+        }
+      }
+      for (; i > 0; --i) {
+        --*this;
+      }
       return *this;
     }
 
-    const_iterator_ operator--(int) {
-      auto tmp = *this;
-      --this->index_;
-      this->update_key_from_index();
-      return tmp;
-    }
-
-    template <std::integral I>
-    const_iterator_ operator+(I i) {
-      return {this->map_, this->keys_, this->index_ + i};
-    }
-
-    template <std::integral I>
-    const_iterator_ operator-(I i) {
-      return {this->map_, this->keys_, this->index_ - i};
-    }
+   private:
+    friend class ordered_map;
+    friend class iterator_base<!IsConst>;
 
-    template <std::integral I>
-    const_iterator_& operator+=(I i) {
-      this->index_ += i;
-      this->update_key_from_index();
-      return *this;
-    }
+    // NOTE: `pos` must either be `last` or refer to an element (i.e. not a tombstone).
+    iterator_base(EntryType* pos, EntryType* first, EntryType* last)
+        : pos_(pos), first_(first), last_(last) {}
 
-    template <std::integral I>
-    const_iterator_& operator-=(I i) {
-      this->index_ -= i;
-      this->update_key_from_index();
-      return *this;
-    }
+    EntryType* pos_{nullptr};
+    EntryType* first_{nullptr};
+    EntryType* last_{nullptr};
   };
 
   // Iterators
-  using iterator = iterator_;
-  using const_iterator = const_iterator_;
+  using iterator = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
@@ -356,8 +332,8 @@ class ordered_map {
   const_iterator begin() const noexcept { return iter_from_index(0); }
   const_iterator cbegin() const noexcept { return begin(); }
 
-  iterator end() noexcept { return {&map_, &keys_, keys_.size()}; }
-  const_iterator end() const noexcept { return {&map_, &keys_, keys_.size()}; }
+  iterator end() noexcept { return iter_from_index(entries_.size()); }
+  const_iterator end() const noexcept { return iter_from_index(entries_.size()); }
   const_iterator cend() const noexcept { return end(); }
 
   // Reverse iterators
@@ -376,37 +352,22 @@ class ordered_map {
   };
 
   void clear() noexcept {
-    map_.clear();
-    keys_.clear();
+    entries_.clear();
+    slots_.clear();
+    size_ = 0;
+    used_slots_ = 0;
   }
 
-  std::pair<iterator, bool> insert(const value_type& x) {
-    if (map_.contains(x.first)) {
-      return {find(x.first), false};
-    }
-    keys_.emplace_back(x.first);
-    map_.insert(x);
-    return {iter_from_key(x.first), true};
-  }
+  std::pair<iterator, bool> insert(const value_type& x) { return try_emplace(x.first, x.second); }
 
   template <typename Pair>
   std::enable_if_t<std::is_convertible_v<value_type, Pair>, std::pair<iterator, bool>> insert(
       Pair&& x) {
-    if (map_.contains(x.first)) {
-      return {find(x.first), false};
-    }
-    keys_.emplace_back(x.first);
-    map_.emplace(std::forward<Pair>(x));
-    return {iter_from_key(x.first), true};
+    return emplace(std::forward<Pair>(x));
   }
 
   std::pair<iterator, bool> insert(value_type&& x) {
-    if (map_.contains(x.first)) {
-      return {find(x.first), false};
-    }
-    keys_.emplace_back(x.first);
-    map_.insert(std::move(x));
-    return {iter_from_key(x.first), true};
+    return try_emplace(x.first, std::move(x.second));
   }
 
   iterator insert(const_iterator /*pos*/, const value_type& value) {
@@ -422,20 +383,17 @@ class ordered_map {
   }
 
   insert_return_type insert(node_type&& nh) {
-    if (!nh) {
+    if (nh.empty()) {
       return {.position = end(), .inserted = false, .node = std::move(nh)};
     }
-    const auto key = nh.key();
-
-    auto map_ret = map_.insert(std::move(nh));
-    if (!map_ret.inserted) {
-      return {.position = find(key), .inserted = false, .node = std::move(map_ret.node)};
+    if (const auto it = find(nh.key()); it != end()) {
+      return {.position = it, .inserted = false, .node = std::move(nh)};
     }
-
-    keys_.emplace_back(key);
-    return {.position = iter_from_key(key),
-            .inserted = map_ret.inserted,
-            .node = std::move(map_ret.node)};
+    auto value = std::move(*nh.value_);
+    nh.value_.reset();
+    return {.position = try_emplace(std::move(value.first), std::move(value.second)).first,
+            .inserted = true,
+            .node = std::move(nh)};
   }
 
   template <class InputIt>
@@ -447,25 +405,20 @@ class ordered_map {
 
   template <class M>
   std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
-    if (map_.contains(key)) {
-      map_[key] = std::forward<M>(obj);
-      return {find(key), false};
+    auto ret = try_emplace(key, std::forward<M>(obj));
+    if (!ret.second) {
+      ret.first->second = std::forward<M>(obj);
     }
-    keys_.emplace_back(key);
-    map_.insert_or_assign(key, std::forward<M>(obj));
-    return {iter_from_key(key), true};
+    return ret;
   }
 
   template <class M>
   std::pair<iterator, bool> insert_or_assign(Key&& k, M&& obj) {
-    if (map_.contains(k)) {
-      map_[k] = std::forward<M>(obj);
-      return {find(k), false};
+    auto ret = try_emplace(std::move(k), std::forward<M>(obj));
+    if (!ret.second) {
+      ret.first->second = std::forward<M>(obj);
     }
-    keys_.emplace_back(k);
-    map_.insert_or_assign(k, std::forward<M>(obj));
-    auto it = iter_from_key(std::move(k));
-    return {it, true};
+    return ret;
   }
 
   template <class M>
@@ -482,295 +435,130 @@ class ordered_map {
 
   template <class... Args>
   std::pair<iterator, bool> emplace(Args&&... args) {
-    // Note: This emplace assumes Args... can be passed to std::make_pair
-    // to form a type that is convertible to value_type.
-    // A more std::map-conformant emplace would directly construct value_type:
-    // value_type temp_element(std::forward<Args>(args)...);
-    // const Key& key_ref = temp_element.first;
-    // if (map_.contains(key_ref)) {
-    //   return {find(key_ref), false};
-    // }
-    // keys_.emplace_back(key_ref);
-    // map_.emplace(std::move(temp_element)); // or map_.insert(std::move(temp_element));
-    // return {find(key_ref), true};
-    // ---
-    // Applying minimal fix to the existing structure:
-    auto value = std::make_pair(std::forward<Args>(args)...);
-    if (map_.contains(value.first)) {
-      return {find(value.first), false};
-    }
-    Key key_copy = value.first;  // Cache key before value (and value.first) is moved.
-    keys_.emplace_back(key_copy);
-    map_.emplace(std::move(value));
-    return {find(key_copy), true};
+    // The element has to be constructed in order to find its key. It is only moved into the map if
+    // the key doesn't already exist.
+    std::pair<Key, T> value(std::forward<Args>(args)...);
+    return try_emplace(std::move(value.first), std::move(value.second));
   }
 
   template <class... Args>
   iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
-    // Args... are used to construct value_type (std::pair<const Key, T>)
-    value_type val(std::forward<Args>(args)...);
-
-    auto map_find_it = map_.find(val.first);
-    if (map_find_it != map_.end()) {
-      return find(val.first);  // Key already exists
-    }
-
-    Key key_for_keys = val.first;
-    keys_.push_back(key_for_keys);
-    map_.insert(std::move(val));  // Use insert to move the constructed val
-    return find(key_for_keys);    // Return iterator to newly inserted element
+    // Hint 'hint' is ignored for placement.
+    return emplace(std::forward<Args>(args)...).first;
   }
 
   template <class... Args>
   std::pair<iterator, bool> try_emplace(const Key& k, Args&&... args) {
-    auto it = map_.find(k);
-    if (it != map_.end()) {
-      return {find(k), false};
-    }
-    keys_.push_back(k);
-    map_.try_emplace(k, std::forward<Args>(args)...);
-    return {find(k), true};
+    return emplace_key(k, std::forward<Args>(args)...);
   }
 
   template <class... Args>
   std::pair<iterator, bool> try_emplace(Key&& k, Args&&... args) {
-    // Find using k before it's moved.
-    auto map_iter = map_.find(k);
-    if (map_iter != map_.end()) {
-      // Key exists, use the key from the map to get our iterator.
-      // k is not moved in this path.
-      return {find(map_iter->first), false};
-    }
-
-    // Key does not exist. We need to move k into map_ and add its value to keys_.
-    // Create a copy of k for keys_ and for find, then move k.
-    Key key_val = k;
-    keys_.push_back(key_val);
-    map_.try_emplace(std::move(k), std::forward<Args>(args)...);
-    return {find(key_val), true};
+    return emplace_key(std::move(k), std::forward<Args>(args)...);
   }
 
   // Behavior is undefined if pos is not a valid dereferenceable iterator.
-  iterator erase(iterator pos) {
-    // Assuming pos is valid and dereferenceable as per typical map::erase contracts.
-    // If pos == end(), behavior is undefined by C++ standard.
-    const auto index = std::distance(begin(), pos);
-    // The key must be obtained before keys_ is modified if index is used on keys_ later.
-    // pos->first is safe here because pos is assumed dereferenceable.
-    auto map_iter_to_erase = map_.find(pos->first);
-    if (map_iter_to_erase != map_.end()) {
-      map_.erase(map_iter_to_erase);
-    }
-    // Erase from keys_ vector by index.
-    if (index < static_cast<decltype(index)>(keys_.size())) {
-      keys_.erase(std::next(std::begin(keys_), index));
-    }
-    return iter_from_index(index);
-  }
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
 
   // Behavior is undefined if pos is not a valid dereferenceable iterator.
   iterator erase(const_iterator pos) {
-    // Assuming pos is valid and dereferenceable.
-    const auto index = std::distance(cbegin(), pos);
-    // assert(index >= 0 && index < static_cast<decltype(index)>(keys_.size()) && "Index out of
-    // bounds for erase");
-
-    auto map_iter_to_erase = map_.find(pos->first);
-    if (map_iter_to_erase != map_.end()) {
-      map_.erase(map_iter_to_erase);
-    }
-    if (index < static_cast<decltype(index)>(keys_.size())) {
-      keys_.erase(keys_.begin() + index);
-    }
-    return iter_from_index(index);
+    const auto index = static_cast<size_type>(pos.pos_ - entries_.data());
+    erase_slot(find_slot(pos->first));
+    return after_erase(index + 1);
   }
 
   iterator erase(const_iterator first, const_iterator last) {
-    if (first == last) {
-      // Need to return a non-const iterator.
-      // first.index_ is the index of the element that would be pointed to.
-      return iter_from_index(first.index_);
-    }
-
-    size_type start_idx = first.index_;
-    size_type end_idx =
-        last.index_;  // This is one past the last element to erase in terms of original indexing.
-
-    // It's generally safer to collect keys and then erase from map,
-    // then erase from vector.
-    std::vector<Key> keys_to_remove_from_map;
-    keys_to_remove_from_map.reserve(end_idx - start_idx);
-    for (size_type i = start_idx; i < end_idx; ++i) {
-      // Check if the key_ optional in the iterator has a value.
-      // However, first and last are const_iterators, their internal key_ might not be directly
-      // accessible or relevant if they are end iterators. We should rely on keys_[i] as the source
-      // of truth for keys.
-      if (i < keys_.size()) {  // Ensure index is valid for keys_
-        keys_to_remove_from_map.push_back(keys_[i]);
-      }
-    }
-
-    for (const auto& key : keys_to_remove_from_map) {
-      map_.erase(key);
-    }
-
-    // Erase from keys_ vector. This invalidates iterators at or after start_idx.
-    if (start_idx < keys_.size()) {  // Ensure start_idx is valid
-      keys_.erase(keys_.begin() + start_idx, keys_.begin() + std::min(end_idx, keys_.size()));
+    // NOTE: Erasing may clear out the tombstones, which invalidates `last`. Count the elements
+    // instead.
+    auto count = std::distance(first, last);
+    auto index = static_cast<size_type>(first.pos_ - entries_.data());
+    for (; count > 0; --count) {
+      const auto it = erase(iter_from_index(index));
+      index = static_cast<size_type>(it.pos_ - entries_.data());
     }
-
-    // The new element at start_idx is the one that followed the erased range.
-    return iter_from_index(start_idx);
+    return iter_from_index(index);
   }
 
   template <typename K>
   size_type erase(const K& key) {
-    // Use the map's find to check for existence efficiently
-    auto map_it = map_.find(key);
-    if (map_it == map_.end()) {
+    const auto slot = find_slot(key);
+    if (slot == kNotFound) {
       return 0;  // Not found
     }
-
-    // Key exists. Get a copy of the key before erasing from the map.
-    Key key_to_erase = map_it->first;
-    map_.erase(map_it);
-
-    // Now erase from the vector
-    auto keys_it = std::find(keys_.begin(), keys_.end(), key_to_erase);
-    if (keys_it != keys_.end()) {
-      keys_.erase(keys_it);
-    }
-
+    erase_slot(slot);
+    after_erase(0);
     return 1;
   }
 
-  void swap(ordered_map& other) noexcept(
-      noexcept(std::declval<Map&>().swap(std::declval<Map&>())) &&
-      noexcept(std::declval<OrderedKeys&>().swap(std::declval<OrderedKeys&>()))) {
-    map_.swap(other.map_);
-    keys_.swap(other.keys_);
+  void swap(ordered_map& other) noexcept {
+    using std::swap;
+    swap(entries_, other.entries_);
+    swap(slots_, other.slots_);
+    swap(size_, other.size_);
+    swap(used_slots_, other.used_slots_);
+    swap(hash_, other.hash_);
+    swap(pred_, other.pred_);
   }
 
   node_type extract(const_iterator position) {
     if (position == cend()) {
       return {};
     }
-    // Use the iterator's public interface to get the key
-    const auto& key_to_extract = position->first;
-
-    auto keys_it = std::find(keys_.begin(), keys_.end(), key_to_extract);
-    if (keys_it != keys_.end()) {
-      keys_.erase(keys_it);
-    }
-    return map_.extract(key_to_extract);
+    // NOTE: The key is const within the map, so it is copied rather than moved.
+    auto& entry = entries_[static_cast<size_type>(position.pos_ - entries_.data())];
+    node_type node(std::pair<Key, T>(entry->first, std::move(entry->second)));
+    erase(position);
+    return node;
   }
 
-  node_type extract(const Key& k) {
-    auto it = std::find(keys_.begin(), keys_.end(), k);
-    if (it != keys_.end()) {
-      keys_.erase(it);
-    }
-    return map_.extract(k);
-  }
+  node_type extract(const Key& k) { return extract(find(k)); }
 
   template <class H2, class P2>
   void merge(ordered_map<Key, T, H2, P2, Alloc>& source) {
-    std::vector<Key> extracted_keys;
-    for (auto& v : source) {
-      if (!map_.contains(v.first)) {
-        extracted_keys.emplace_back(v.first);
-        insert(std::move(source.map_.extract(v.first)));
-      }
+    if (static_cast<void*>(this) == static_cast<void*>(&source)) {  // Self-merge is a no-op
+      return;
     }
-
-    // Need to remove the keys from the source map that have been extracted
-    for (const auto& k : extracted_keys) {
-      source.keys_.erase(std::find(source.keys_.begin(), source.keys_.end(), k));
+    // Each element whose key isn't already in this map is moved over, in the order of `source`.
+    for (auto it = source.begin(); it != source.end();) {
+      if (contains(it->first)) {
+        ++it;
+        continue;
+      }
+      try_emplace(it->first, std::move(it->second));
+      it = source.erase(it);
     }
   }
 
   template <class H2, class P2>
   void merge(ordered_map<Key, T, H2, P2, Alloc>&& source) {
-    // Iterate through source. For each element, if its key is not in this map,
-    // extract the node from source and insert it into this.
-    // Since source is an rvalue reference, its elements can be moved from.
-    // Ensure keys_ in both this and source are correctly updated.
-    if (this == &source) {  // Self-merge is a no-op
-      return;
-    }
-
-    std::vector<Key> keys_to_remove_from_source;
-    // Iterate using source's order. A bit tricky as source.keys_ will be modified.
-    // Best to iterate over a copy of source.keys_ or use indices carefully.
-    // Or, iterate while source is not empty, always processing its first element.
-
-    // Let's try iterating over source's keys by index before they are removed.
-    // This requires source.keys_ not to be modified during this loop in a way that invalidates
-    // indices. We will modify source.map_ by extracting nodes, and collect keys to remove from
-    // source.keys_ later.
-
-    for (const auto& key_in_source : source.keys_) {  // Iterate over a snapshot of keys if
-                                                      // source.keys_ could change due to extract.
-      // However, map_.extract() doesn't change other map elements or keys_ vector.
-      // What changes source.keys_ is our explicit removal.
-      if (!this->map_.contains(key_in_source)) {
-        node_type extracted_node = source.map_.extract(key_in_source);
-        if (extracted_node) {                       // Ensure node was actually extracted
-          this->insert(std::move(extracted_node));  // This handles this->keys_ and this->map_
-          keys_to_remove_from_source.push_back(key_in_source);
-        }
-      }
-    }
-
-    // Now, remove the moved keys from source.keys_
-    // This needs to be done carefully to avoid iterator invalidation issues if using erase-remove
-    // idiom directly. A simpler way for potentially many removals:
-    if (!keys_to_remove_from_source.empty()) {
-      OrderedKeys new_source_keys;
-      new_source_keys.reserve(source.keys_.size() - keys_to_remove_from_source.size());
-      // Create a set of keys to remove for faster lookups
-      std::unordered_set<Key, Hash, Pred> keys_removed_set(keys_to_remove_from_source.begin(),
-                                                           keys_to_remove_from_source.end());
-      for (const auto& k : source.keys_) {
-        if (keys_removed_set.find(k) == keys_removed_set.end()) {
-          new_source_keys.push_back(k);
-        }
-      }
-      source.keys_ = std::move(new_source_keys);
-    }
-    // Allocator handling: if allocators are different and nodes are moved,
-    // the behavior is defined by std::unordered_map::insert(node_type&&).
-    // If allocators don't match, it might copy/move construct new elements instead of just linking
-    // the node. This is standard behavior.
+    merge(source);
   }
 
   template <typename K>
   T& at(const K& key) {
-    return map_.at(key);
+    const auto index = find_index(key);
+    if (index == kNotFound) {
+      throw std::out_of_range("ordered_map::at: key not found");
+    }
+    return entries_[index]->second;
   }
 
   template <typename K>
   const T& at(const K& key) const {
-    return map_.at(key);
-  }
-
-  T& operator[](const Key& key) {
-    if (!map_.contains(key)) {
-      keys_.push_back(key);
+    const auto index = find_index(key);
+    if (index == kNotFound) {
+      throw std::out_of_range("ordered_map::at: key not found");
     }
-    return map_[key];
+    return entries_[index]->second;
   }
 
-  T& operator[](Key&& key) {
-    if (!map_.contains(key)) {
-      keys_.push_back(key);
-    }
-    return map_[key];
-  }
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+  T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
 
   template <typename K>
   size_type count(const K& x) const {
-    return map_.count(x);
+    return contains(x) ? 1 : 0;
   }
 
   template <typename K>
@@ -785,7 +573,7 @@ class ordered_map {
 
   template <typename K>
   bool contains(const K& x) const {
-    return map_.contains(x);
+    return find_index(x) != kNotFound;
   }
 
   template <typename K>
@@ -838,7 +626,7 @@ class ordered_map {
     return it;  // If key not found, find(key) is end(), so returns end(). If found, returns next.
   }
 
-  key_equal key_comp() const { return map_.key_eq(); }  // Returns Pred, which is key_equal
+  key_equal key_comp() const { return pred_; }  // Returns Pred, which is key_equal
 
   class value_compare {
     friend class ordered_map;
@@ -857,33 +645,172 @@ class ordered_map {
 
  protected:
   template <typename K>
-  size_t get_index(const K& key) const {
-    // 1. Use the map's find first.
-    auto map_it = map_.find(key);
-    if (map_it == map_.end()) {
-      return keys_.size();  // Key not found, return an index that will translate to end().
+  size_type hash(const K& key) const {
+    if constexpr (IsTransparentKey<K, Key, Hash, Pred>) {
+      return hash_(key);
+    } else {
+      return hash_(Key(key));
+    }
+  }
+
+  // The part of the hash kept in each slot. The low bits already pick the slot, so use the high
+  // bits.
+  static std::uint32_t hash_tag(size_type hash) {
+    return static_cast<std::uint32_t>(hash >> (std::numeric_limits<size_type>::digits - 32));
+  }
+
+  // Finds the slot that refers to `key`, or `kNotFound`.
+  template <typename K>
+  size_type find_slot(const K& key) const {
+    if constexpr (!IsTransparentKey<K, Key, Hash, Pred>) {
+      return find_slot<Key>(Key(key));
+    } else {
+      return probe(key, hash(key));
+    }
+  }
+
+  // Finds the slot that refers to `key` (whose hash is `h`), or `kNotFound`.
+  template <typename K>
+  size_type probe(const K& key, size_type h) const {
+    if (slots_.empty()) {
+      return kNotFound;
+    }
+    const auto tag = hash_tag(h);
+    const auto mask = slots_.size() - 1;
+    // NOTE: There is always at least one empty slot, so this terminates.
+    for (auto s = h & mask;; s = (s + 1) & mask) {
+      const auto& slot = slots_[s];
+      if (slot.entry == kEmpty) {
+        return kNotFound;
+      }
+      if (slot.entry != kTombstone && slot.hash == tag && pred_(entries_[slot.entry]->first, key)) {
+        return s;
+      }
+    }
+  }
+
+  // Finds the index of the entry holding `key`, or `kNotFound`.
+  template <typename K>
+  size_type find_index(const K& key) const {
+    const auto slot = find_slot(key);
+    return slot == kNotFound ? kNotFound : slots_[slot].entry;
+  }
+
+  // Adds an element (constructed from `args`) with the given key, unless the key already exists.
+  template <typename K, class... Args>
+  std::pair<iterator, bool> emplace_key(K&& key, Args&&... args) {
+    // Look for the key before making room for it. Finding an existing key must leave every element
+    // in place, as `key` (or the caller's loop, e.g. `for (auto& kv : m) m[kv.first] = ...`) may
+    // refer to one of them.
+    const auto h = hash(key);
+    if (const auto found = probe(key, h); found != kNotFound) {
+      return {iter_from_index(slots_[found].entry), false};
+    }
+    if ((used_slots_ + 1) * 8 > slots_.size() * 7) {
+      rebuild_slots(size_ + 1);
+    }
+    // The key isn't present, so it goes in the first slot that is empty (or a tombstone).
+    const auto mask = slots_.size() - 1;
+    auto s = h & mask;
+    while (slots_[s].entry != kEmpty && slots_[s].entry != kTombstone) {
+      s = (s + 1) & mask;
+    }
+    if (slots_[s].entry == kEmpty) {
+      ++used_slots_;
+    }
+
+    entries_.emplace_back(std::in_place, std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<K>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+    slots_[s] = {static_cast<std::uint32_t>(entries_.size() - 1), hash_tag(h)};
+    ++size_;
+    return {iter_from_index(entries_.size() - 1), true};
+  }
+
+  // Leaves a tombstone in place of the slot & its entry.
+  void erase_slot(size_type slot) {
+    entries_[slots_[slot].entry].reset();
+    slots_[slot].entry = kTombstone;
+    --size_;
+  }
+
+  // Clears out the tombstones once they make up most of the entries. Returns an iterator to the
+  // first element at or after `index` (which is the position of an entry before clearing them).
+  iterator after_erase(size_type index) {
+    const auto erased = entries_.size() - size_;
+    if (erased <= size_ || erased < kMinSlots) {
+      return iter_from_index(index);
+    }
+    const auto live_before = std::count_if(
+        entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(index),
+        [](const Entry& entry) { return entry.has_value(); });
+    compact();
+    return iter_from_index(static_cast<size_type>(live_before));
+  }
+
+  // Drops all tombstones from the entries (which moves the elements), and rebuilds the index table.
+  void compact() {
+    Entries live(entries_.get_allocator());
+    live.reserve(size_);
+    for (auto& entry : entries_) {
+      if (entry) {
+        live.emplace_back(std::move(entry));
+      }
     }
+    entries_ = std::move(live);
+    rebuild_slots(size_);
+  }
 
-    // 2. Key was found. Now find its position in the insertion-order vector.
-    //    map_it->first is of type `const Key&`, which is what `std::find` needs.
-    const auto keys_it = std::find(std::begin(keys_), std::end(keys_), map_it->first);
-    const auto idx = std::distance(std::begin(keys_), keys_it);
-    assert(idx >= 0 && "Expected element idx to be non-negative");
-    return static_cast<size_t>(idx);
+  // Rebuilds the index table with room for (at least) `n` elements. The entries aren't touched, so
+  // this drops the tombstones from the table but not from the entries.
+  void rebuild_slots(size_type n) {
+    // Keep the table at most half full, so that the probe sequences stay short.
+    slots_.assign(std::max(kMinSlots, std::bit_ceil(2 * n)), Slot{});
+    used_slots_ = size_;
+    const auto mask = slots_.size() - 1;
+    for (size_type i = 0; i < entries_.size(); ++i) {
+      if (!entries_[i]) {
+        continue;
+      }
+      const auto h = hash(entries_[i]->first);
+      auto s = h & mask;
+      while (slots_[s].entry != kEmpty) {
+        s = (s + 1) & mask;
+      }
+      slots_[s] = {static_cast<std::uint32_t>(i), hash_tag(h)};
+    }
   }
 
-  // Helpers for creating iterators
-  iterator iter_from_index(size_t index) { return {&map_, &keys_, index}; }
-  const_iterator iter_from_index(size_t index) const { return {&map_, &keys_, index}; }
+  // Helpers for creating iterators. These skip forward over any tombstones.
+  iterator iter_from_index(size_t index) {
+    auto* first = entries_.data();
+    auto* last = first + entries_.size();
+    auto* pos = first + std::min(index, entries_.size());
+    while (pos != last && !pos->has_value()) {
+      ++pos;
+    }
+    return {pos, first, last};
+  }
+  const_iterator iter_from_index(size_t index) const {
+    const auto* first = entries_.data();
+    const auto* last = first + entries_.size();
+    const auto* pos = first + std::min(index, entries_.size());
+    while (pos != last && !pos->has_value()) {
+      ++pos;
+    }
+    return {pos, first, last};
+  }
 
   template <typename K>
   iterator iter_from_key(const K& key) {
-    return {&map_, &keys_, get_index(key)};
+    const auto index = find_index(key);
+    return iter_from_index(index == kNotFound ? entries_.size() : index);
   }
   template <typename K>
   const_iterator iter_from_key(const K& key) const {
-    return {&map_, &keys_, get_index(key)};
+    const auto index = find_index(key);
+    return iter_from_index(index == kNotFound ? entries_.size() : index);
   }
 };
 
-}  // namespace flexi_cfg::details
\ No newline at end of file
+}  // namespace flexi_cfg::details
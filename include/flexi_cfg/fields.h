@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string_view>
+#include <tuple>
+
+namespace flexi_cfg {
+
+/// \brief A field of a struct that can be populated by `Reader::bind` (see `FLEXI_CFG_FIELDS`)
+template <typename T, typename M>
+struct Field {
+  using value_type = M;
+
+  /// The key of the field within the config struct
+  std::string_view name;
+  M T::*member;
+};
+
+/// \brief Satisfied by the structs whose fields are declared with `FLEXI_CFG_FIELDS`
+template <typename T>
+concept Bindable = requires(const T* value) {
+  { flexiCfgFields(value) };
+};
+
+namespace details {
+/// \brief The fields of a `Bindable` struct (as a tuple of `Field`), known at compile time
+template <Bindable T>
+constexpr auto fields() {
+  return flexiCfgFields(static_cast<const T*>(nullptr));
+}
+}  // namespace details
+
+}  // namespace flexi_cfg
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+// Applies `MACRO(TYPE, field)` to each field, separated by commas. `FLEXI_CFG_EXPAND` rescans its
+// argument 256 times, which limits a struct to 256 fields.
+#define FLEXI_CFG_PARENS ()
+#define FLEXI_CFG_EXPAND(...) \
+  FLEXI_CFG_EXPAND4(FLEXI_CFG_EXPAND4(FLEXI_CFG_EXPAND4(FLEXI_CFG_EXPAND4(__VA_ARGS__))))
+#define FLEXI_CFG_EXPAND4(...) \
+  FLEXI_CFG_EXPAND3(FLEXI_CFG_EXPAND3(FLEXI_CFG_EXPAND3(FLEXI_CFG_EXPAND3(__VA_ARGS__))))
+#define FLEXI_CFG_EXPAND3(...) \
+  FLEXI_CFG_EXPAND2(FLEXI_CFG_EXPAND2(FLEXI_CFG_EXPAND2(FLEXI_CFG_EXPAND2(__VA_ARGS__))))
+#define FLEXI_CFG_EXPAND2(...) \
+  FLEXI_CFG_EXPAND1(FLEXI_CFG_EXPAND1(FLEXI_CFG_EXPAND1(FLEXI_CFG_EXPAND1(__VA_ARGS__))))
+#define FLEXI_CFG_EXPAND1(...) __VA_ARGS__
+#define FLEXI_CFG_FOR_EACH(MACRO, TYPE, ...) \
+  __VA_OPT__(FLEXI_CFG_EXPAND(FLEXI_CFG_FOR_EACH_HELPER(MACRO, TYPE, __VA_ARGS__)))
+#define FLEXI_CFG_FOR_EACH_HELPER(MACRO, TYPE, FIELD, ...) \
+  MACRO(TYPE, FIELD)                                       \
+  __VA_OPT__(, FLEXI_CFG_FOR_EACH_AGAIN FLEXI_CFG_PARENS(MACRO, TYPE, __VA_ARGS__))
+#define FLEXI_CFG_FOR_EACH_AGAIN() FLEXI_CFG_FOR_EACH_HELPER
+
+#define FLEXI_CFG_FIELD(TYPE, FIELD) \
+  ::flexi_cfg::Field<TYPE, decltype(TYPE::FIELD)> { #FIELD, &TYPE::FIELD }
+
+/// \brief Declares the fields of `TYPE` that `Reader::bind` populates. The name of each field is
+///        also its key in the config. Each field may be anything that `Reader::getValue` can read,
+///        or another struct declared with this macro. This must be used in the namespace of `TYPE`
+///        (so it is found through ADL), e.g.
+///
+///            struct Gains {
+///              double kp{};
+///              double ki{};
+///              double kd{};
+///            };
+///            FLEXI_CFG_FIELDS(Gains, kp, ki, kd);
+#define FLEXI_CFG_FIELDS(TYPE, ...)                                               \
+  [[maybe_unused]] constexpr auto flexiCfgFields(const TYPE* /*unused*/) {        \
+    return std::make_tuple(FLEXI_CFG_FOR_EACH(FLEXI_CFG_FIELD, TYPE, __VA_ARGS__)); \
+  }                                                                                \
+  static_assert(true, "")
+// NOLINTEND(cppcoreguidelines-macro-usage)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace flexi_cfg::generator {
+
+/// \brief Tunable parameters of a generated config
+///
+/// The total number of keys in the resolved config is:
+///   structs * depth * keys_per_struct + protos * references_per_proto * keys_per_proto +
+///   value_lookups + expressions
+struct Options {
+  /// Seed of the random number generator. The same options always produce the same config.
+  std::uint64_t seed{0};
+  /// Number of top level structs
+  std::size_t structs{10};
+  /// Nesting level of each top level struct (including the top level struct itself)
+  std::size_t depth{2};
+  /// Number of key/value pairs at each level of a struct
+  std::size_t keys_per_struct{8};
+  /// Number of protos (all contained in the `protos` struct)
+  std::size_t protos{2};
+  /// Number of key/value pairs in each proto
+  std::size_t keys_per_proto{6};
+  /// Number of times each proto is referenced (distributed across the top level structs)
+  std::size_t references_per_proto{2};
+  /// Number of `$(...)` value lookups (distributed across the top level structs)
+  std::size_t value_lookups{4};
+  /// Number of `{{ }}` expressions (distributed across the top level structs)
+  std::size_t expressions{4};
+  /// Number of `[override]` keys. Each overrides a distinct numeric key.
+  std::size_t overrides{2};
+  /// Number of files included by the root config file. The top level structs are distributed
+  /// across the root config and all included files.
+  std::size_t include_files{0};
+  /// Base name of the generated files (i.e. `<name>.cfg`, `<name>_1.cfg`, ...)
+  std::string name{"generated"};
+};
+
+/// \brief The output of the generator.
+struct GeneratedConfig {
+  /// Filename/contents pairs. The first entry is always the root config file.
+  std::vector<std::pair<std::string, std::string>> files;
+  /// The number of keys (leaf key/value pairs) in the resolved config
+  std::size_t key_count{0};
+
+  /// \brief The contents of the root config file. When there are no include files, this is the
+  ///        complete config and may be passed directly to `flexi_cfg::parseFromString`.
+  [[nodiscard]] auto root() const -> const std::string& { return files.front().second; }
+
+  /// \brief Writes all files into the given directory (which is created if necessary)
+  /// \param[in] dir - The output directory
+  /// \return The path of the root config file
+  auto write(const std::filesystem::path& dir) const -> std::filesystem::path;
+};
+
+/// \brief Generate a valid config based on the given options.
+/// \param[in] options - The parameters of the config to generate
+/// \return The generated config files
+auto generate(const Options& options) -> GeneratedConfig;
+
+/// \brief Provides a set of options resulting in a config with approximately `n_keys` keys, with a
+///        realistic mix of protos, references, lookups, expressions, overrides and includes.
+/// \param[in] n_keys - The desired number of keys
+/// \param[in] seed - The seed of the random number generator
+auto optionsForKeyCount(std::size_t n_keys, std::uint64_t seed = 0) -> Options;
+
+}  // namespace flexi_cfg::generator
@@ -4,16 +4,42 @@
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <magic_enum.hpp>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <string_view>
+#include <utility>
+#include <vector>
+
+// Messages below this level are compiled out entirely (e.g. set to 2 (INFO) to remove all TRACE &
+// DEBUG messages). See `CFG_MIN_LOG_LEVEL` in the top level CMakeLists.txt.
+#ifndef FLEXI_CFG_MIN_LOG_LEVEL
+#define FLEXI_CFG_MIN_LOG_LEVEL 0
+#endif
 
 namespace flexi_cfg::logger {
 
 enum class Severity : uint8_t { TRACE = 0, DEBUG, INFO, WARN, ERROR, CRITICAL };
 
+inline constexpr Severity MIN_LOG_LEVEL{static_cast<Severity>(FLEXI_CFG_MIN_LOG_LEVEL)};
+
+/// \brief Messages that were held back (see `ScopedCapture`) instead of being printed
+using Messages = std::vector<std::pair<Severity, std::string>>;
+
+namespace internal {
+/// \brief Where the messages logged on the current thread are held, or `nullptr` to print them.
+inline auto capture() -> Messages*& {
+  thread_local Messages* capture_s{nullptr};
+  return capture_s;
+}
+}  // namespace internal
+
+/// \brief Safe to use from multiple threads. Checking whether a level is enabled never blocks, and
+///        each message is printed whole (messages from different threads are never interleaved).
 class Logger {
  public:
   Logger() = default;
@@ -23,20 +49,41 @@ class Logger {
     return instance_s;
   }
 
-  void setLevel(Severity level) { log_level_ = level; }
-  [[nodiscard]] auto logLevel() const -> Severity { return log_level_; }
+  void setLevel(Severity level) { log_level_.store(level, std::memory_order_relaxed); }
+  [[nodiscard]] auto logLevel() const -> Severity {
+    return log_level_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Checks if a message at the given level will be logged
+  [[nodiscard]] auto enabled(Severity level) const -> bool {
+    return level >= MIN_LOG_LEVEL && level >= logLevel();
+  }
 
   template <typename... Args>
   void log(Severity level, std::string_view msg_f, Args&&... args) {
-    const auto msg = fmt::vformat(msg_f, fmt::make_format_args(args...));
-    if (level >= log_level_) {
-      // NOTE: The clear format sequence shouldn't be necessary, but appears to be.
-      fmt::print(fg_color_.at(level), "[{}] {}\x1b[0m\n", level, msg);
+    // Check the level before formatting anything. Most trace/debug messages are never printed, so
+    // the (potentially large) message should only be built when it will actually be used.
+    if (!enabled(level)) {
+      return;
+    }
+    print(level, fmt::vformat(msg_f, fmt::make_format_args(args...)));
+  }
+
+  /// \brief Prints a formatted message (or holds it, if the current thread is capturing)
+  void print(Severity level, std::string msg) {
+    if (auto* held = internal::capture(); held != nullptr) {
+      held->emplace_back(level, std::move(msg));
+      return;
     }
+    // Only the printing is serialized. The message is formatted outside of the lock.
+    const std::lock_guard lock(print_mutex_);
+    // NOTE: The clear format sequence shouldn't be necessary, but appears to be.
+    fmt::print(fg_color_.at(level), "[{}] {}\x1b[0m\n", level, msg);
   }
 
  private:
-  Severity log_level_{Severity::INFO};
+  std::atomic<Severity> log_level_{Severity::INFO};
+  std::mutex print_mutex_;
 
   const std::unordered_map<Severity, fmt::text_style> fg_color_ = {
       {Severity::TRACE, fmt::fg(fmt::color::magenta)},
@@ -49,8 +96,35 @@ class Logger {
   // This container holds a history of messages to provide a type of "backtrace" functionality
 };
 
+/// \brief Holds the messages logged on the current thread in `messages` (rather than printing
+///        them) for the lifetime of this object. This allows work that may be discarded (and
+///        redone) to only log anything once it is known to be kept.
+class ScopedCapture {
+ public:
+  explicit ScopedCapture(Messages& messages) : previous_{internal::capture()} {
+    internal::capture() = &messages;
+  }
+  ~ScopedCapture() { internal::capture() = previous_; }
+
+  ScopedCapture(const ScopedCapture&) = delete;
+  auto operator=(const ScopedCapture&) -> ScopedCapture& = delete;
+  ScopedCapture(ScopedCapture&&) = delete;
+  auto operator=(ScopedCapture&&) -> ScopedCapture& = delete;
+
+ private:
+  Messages* previous_;
+};
+
+/// \brief Logs the messages that were held back by a `ScopedCapture`
+inline void replay(const Messages& messages) {
+  for (const auto& [level, msg] : messages) {
+    Logger::instance().print(level, msg);
+  }
+}
+
 static void setLevel(Severity lvl) { Logger::instance().setLevel(lvl); }
 static auto logLevel() -> Severity { return Logger::instance().logLevel(); }
+static auto enabled(Severity lvl) -> bool { return Logger::instance().enabled(lvl); }
 
 template <typename... Args>
 static void log(Severity level, std::string_view msg_f, Args&&... args) {
@@ -59,11 +133,15 @@ static void log(Severity level, std::string_view msg_f, Args&&... args) {
 
 template <typename... Args>
 static void trace(std::string_view msg_f, Args&&... args) {
-  Logger::instance().log(Severity::TRACE, msg_f, std::forward<Args>(args)...);
+  if constexpr (Severity::TRACE >= MIN_LOG_LEVEL) {
+    Logger::instance().log(Severity::TRACE, msg_f, std::forward<Args>(args)...);
+  }
 }
 template <typename... Args>
 static void debug(std::string_view msg_f, Args&&... args) {
-  Logger::instance().log(Severity::DEBUG, msg_f, std::forward<Args>(args)...);
+  if constexpr (Severity::DEBUG >= MIN_LOG_LEVEL) {
+    Logger::instance().log(Severity::DEBUG, msg_f, std::forward<Args>(args)...);
+  }
 }
 template <typename... Args>
 static void info(std::string_view msg_f, Args&&... args) {
@@ -82,8 +160,16 @@ static void critical(std::string_view msg_f, Args&&... args) {
   Logger::instance().log(Severity::CRITICAL, msg_f, std::forward<Args>(args)...);
 }
 
-static void trace(std::string_view msg) { Logger::instance().log(Severity::TRACE, msg); }
-static void debug(std::string_view msg) { Logger::instance().log(Severity::DEBUG, msg); }
+static void trace(std::string_view msg) {
+  if constexpr (Severity::TRACE >= MIN_LOG_LEVEL) {
+    Logger::instance().log(Severity::TRACE, msg);
+  }
+}
+static void debug(std::string_view msg) {
+  if constexpr (Severity::DEBUG >= MIN_LOG_LEVEL) {
+    Logger::instance().log(Severity::DEBUG, msg);
+  }
+}
 static void info(std::string_view msg) { Logger::instance().log(Severity::INFO, msg); }
 static void warn(std::string_view msg) { Logger::instance().log(Severity::WARN, msg); }
 static void error(std::string_view msg) { Logger::instance().log(Severity::ERROR, msg); }
@@ -91,9 +177,13 @@ static void critical(std::string_view msg) { Logger::instance().log(Severity::CR
 
 }  // namespace flexi_cfg::logger
 
-#define LOG(SEVERITY, MSG_F, ...)  \
-  flexi_cfg::logger::log(SEVERITY, \
-                         fmt::format("{}:{} - " MSG_F, __FILE__, __LINE__, ##__VA_ARGS__));
+// The arguments are only evaluated (and the message only formatted) if the message will be logged.
+#define LOG(SEVERITY, MSG_F, ...)                                                             \
+  do {                                                                                        \
+    if (flexi_cfg::logger::enabled(SEVERITY)) {                                               \
+      flexi_cfg::logger::log(SEVERITY, "{}:{} - " MSG_F, __FILE__, __LINE__, ##__VA_ARGS__); \
+    }                                                                                         \
+  } while (false)
 
 #define LOG_T(MSG_F, ...) LOG(flexi_cfg::logger::Severity::TRACE, MSG_F, ##__VA_ARGS__)
 #define LOG_D(MSG_F, ...) LOG(flexi_cfg::logger::Severity::DEBUG, MSG_F, ##__VA_ARGS__)
@@ -8,6 +8,7 @@
 #include "flexi_cfg/logger.h"
 #include "flexi_cfg/math/grammar.h"
 #include "flexi_cfg/math/helpers.h"
+#include "flexi_cfg/math/program.h"
 #include "flexi_cfg/utils.h"
 
 // NOTE: A large portion of this code was derived from:
@@ -126,4 +127,81 @@ struct action<Bo> {
   }
 };
 
+/// The actions below compile an expression to a `Program` instead of evaluating it. They mirror the
+/// actions above.
+
+struct CompileData {
+  ProgramBuilder builder{};
+
+  // Track open/close brackets to know when to finalize the program.
+  size_t bracket_cnt{0};
+
+  Program program{};
+};
+
+template <typename Rule>
+struct compile_action : peg::nothing<Rule> {};
+
+template <>
+struct compile_action<config::NUMBER> {
+  template <typename ActionInput>
+  static void apply(const ActionInput& in, CompileData& out) {
+    out.builder.pushConstant(std::stod(in.string()));
+  }
+};
+
+template <>
+struct compile_action<pi> {
+  static void apply0(CompileData& out) { out.builder.pushConstant(M_PI); }
+};
+
+template <>
+struct compile_action<Um> {
+  static void apply0(CompileData& out) { out.builder.pushOperator(Program::Op::kNeg); }
+};
+
+template <>
+struct compile_action<Po> {
+  static void apply0(CompileData& out) {
+    out.builder.open();
+    out.bracket_cnt++;
+  }
+};
+
+template <>
+struct compile_action<Pc> {
+  static void apply0(CompileData& out) {
+    out.builder.close();
+    out.bracket_cnt--;
+  }
+};
+
+template <>
+struct compile_action<expression> {
+  static void apply0(CompileData& out) {
+    if (out.bracket_cnt == 0) {
+      out.program = out.builder.finish();
+    }
+  }
+};
+
+template <>
+struct compile_action<config::VALUE_LOOKUP> {
+  template <typename ActionInput>
+  static void apply(const ActionInput& in, CompileData& out) {
+    out.builder.pushSlot(utils::trim(utils::removeSubStr(in.string(), "$("), ")"));
+  }
+};
+
+template <>
+struct compile_action<Bo> {
+  template <typename ActionInput>
+  static void apply(const ActionInput& in, CompileData& out) {
+    static const std::map<std::string, Program::Op> ops = {
+        {"+", Program::Op::kAdd}, {"-", Program::Op::kSub}, {"*", Program::Op::kMul},
+        {"/", Program::Op::kDiv}, {"^", Program::Op::kPow}, {"**", Program::Op::kPow}};
+    out.builder.pushOperator(ops.at(in.string()));
+  }
+};
+
 }  // namespace flexi_cfg::math
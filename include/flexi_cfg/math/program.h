@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace flexi_cfg::math {
+
+/// \brief An expression compiled to reverse polish notation. The operations are performed in
+///        exactly the same order as the shunting yard evaluation in `math::Stack`, so the results
+///        are identical. A program is immutable once compiled, so it can be shared between all
+///        copies of an expression.
+struct Program {
+  enum class Op : uint8_t {
+    kConstant,  // Push `constants[arg]`
+    kSlot,      // Push the value bound to `slots[arg]`
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kPow,
+    kNeg,  // Unary minus
+  };
+
+  struct Instruction {
+    Op op{Op::kConstant};
+    uint32_t arg{0};
+  };
+
+  std::vector<Instruction> code{};
+  std::vector<double> constants{};
+  /// The value lookups (e.g. `a.b` for `$(a.b)`) used by the expression, in order of first use.
+  std::vector<std::string> slots{};
+  /// The maximum depth of the value stack while evaluating `code`.
+  std::size_t max_depth{0};
+
+  /// \brief Evaluates the program
+  /// \param[in] slot_values - The value of each of `slots` (in the same order)
+  /// \return The result of the expression
+  [[nodiscard]] auto evaluate(std::span<const double> slot_values = {}) const -> double;
+};
+
+/// \brief Converts the infix operations to a `Program` as they are parsed.
+class ProgramBuilder {
+ public:
+  ProgramBuilder();
+
+  void pushConstant(double v);
+
+  void pushSlot(const std::string& var_ref);
+
+  /// \brief Pushes a binary operator (or `kNeg`) onto the operator stack. Any pending operators of
+  ///        higher precedence are emitted first.
+  void pushOperator(Program::Op op);
+
+  void open();
+
+  void close();
+
+  auto finish() -> Program;
+
+ private:
+  void emit(Program::Op op, uint32_t arg = 0);
+
+  /// \brief Emits all pending operators of the current (bracketed) level.
+  void flush();
+
+  Program program_{};
+  // The pending operators, one stack per level of brackets.
+  std::vector<std::vector<Program::Op>> ops_{};
+  std::size_t depth_{0};
+};
+
+/// \brief Compiles an expression (including the enclosing `{{` & `}}`)
+/// \param[in] expression - The expression to compile
+/// \param[in] source - The name of the source of the expression (used for error reporting)
+/// \return The compiled program
+auto compile(const std::string& expression, const std::string& source)
+    -> std::shared_ptr<const Program>;
+
+}  // namespace flexi_cfg::math
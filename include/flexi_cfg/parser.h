@@ -9,22 +9,70 @@
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/classes.h"
 #include "flexi_cfg/reader.h"
+#include "flexi_cfg/stats.h"
 
 namespace flexi_cfg {
 
 class Parser {
  public:
+  /// \brief Parse a config file (and any included files)
+  /// \param[in] cfg_filename - The config file to parse
+  /// \param[in] root_dir - Optional root directory from which `cfg_filename` is resolved
+  /// \param[out] stats - Optional. If provided, filled with timing & counters of the parse
+  /// \param[in] threads - The number of threads used to parse the included files (0 to use one per
+  ///                      core). With more than one, the includes are found first, then all of the
+  ///                      files are parsed concurrently. The result (or error) is unchanged.
   static auto parse(const std::filesystem::path& cfg_filename,
-                    std::optional<std::filesystem::path> root_dir = std::nullopt) -> Reader;
+                    std::optional<std::filesystem::path> root_dir = std::nullopt,
+                    ParseStats* stats = nullptr, unsigned threads = 1) -> Reader;
+
+  /// \brief Parse an in-memory config
+  /// \param[in] cfg_string - The contents of the config
+  /// \param[in] source - The name used to identify the config in log & error messages
+  /// \param[out] stats - Optional. If provided, filled with timing & counters of the parse
+  static auto parseFromString(std::string_view cfg_string, std::string_view source = "unknown",
+                              ParseStats* stats = nullptr) -> Reader;
+
+ protected:
+  /// \brief The individual steps performed by `resolveConfig`, in the order in which they run.
+  enum class Phase {
+    kFlattenAndFindProtos,
+    kResolveReferences,
+    kMergeNested,
+    kValidateAndApplyOverrides,
+    kStripProtos,
+    kUnflatten,
+    kResolveVarRefs,
+    kEvaluateExpressions,
+    kCleanupConfig
+  };
 
-  static auto parseFromString(std::string_view cfg_string, std::string_view source = "unknown")
-      -> Reader;
-
- private:
   Parser() = default;
 
+  /// \brief Run the PEG parser over a config file (and any included files)
+  /// \param[in] cfg_filename - The config file to parse
+  /// \param[in] root_dir - Optional root directory from which `cfg_filename` is resolved
+  /// \param[in] threads - The number of threads used to parse the files (see `parse`)
+  /// \return The unresolved parse result, ready to be passed to `resolveConfig`
+  static auto parseFileToState(const std::filesystem::path& cfg_filename,
+                               const std::optional<std::filesystem::path>& root_dir,
+                               unsigned threads = 1) -> config::ActionData;
+
+  /// \brief Run the PEG parser over an in-memory config
+  /// \param[in] cfg_string - The contents of the config
+  /// \param[in] source - The name used to identify the config in log & error messages
+  /// \return The unresolved parse result, ready to be passed to `resolveConfig`
+  static auto parseStringToState(std::string_view cfg_string, std::string_view source)
+      -> config::ActionData;
+
   auto resolveConfig(config::ActionData& state) -> const config::types::CfgMap&;
 
+  /// \brief Run a single step of `resolveConfig`. Each phase expects all of the preceding phases
+  ///        to have been run on the same `state` (and by the same parser instance).
+  /// \param[in] phase - The step to run
+  /// \param[in/out] state - The state of the parser run
+  void resolvePhase(Phase phase, config::ActionData& state);
+
   auto flattenAndFindProtos(const config::types::CfgMap& in, const std::string& base_name,
                             config::types::CfgMap flattened = {}) -> config::types::CfgMap;
 
@@ -40,25 +88,31 @@ class Parser {
   /// @brief Validate the keys in the override list and apply them to the config map
   /// @param state The state of the parser run
   /// @param cfg_map The config map object generated by the parser run
-  static void validateAndApplyOverrides(const config::ActionData& state, config::types::CfgMap& cfg_map) ;
+  static void validateAndApplyOverrides(const config::ActionData& state,
+                                        config::types::CfgMap& cfg_map);
 
   /// \brief Remove the protos from merged dictionary
   /// \param[in/out] cfg_map - The top level (resolved) config map
   void stripProtos(config::types::CfgMap& cfg_map) const;
 
+  /// \brief Convert all of the flat (dot-separated) keys at the top level into nested structs
+  /// \param[in/out] cfg_map - The top level (resolved) config map
+  static void unflattenKeys(config::types::CfgMap& cfg_map);
+
   config::types::ProtoMap protos_{};
 
   config::types::CfgMap cfg_data_;
 };
 
 inline auto parse(const std::filesystem::path& cfg_filename,
-                  std::optional<std::filesystem::path> root_dir = std::nullopt) -> Reader {
-  return Parser::parse(cfg_filename, root_dir);
+                  std::optional<std::filesystem::path> root_dir = std::nullopt,
+                  ParseStats* stats = nullptr, unsigned threads = 1) -> Reader {
+  return Parser::parse(cfg_filename, root_dir, stats, threads);
 }
 
-inline auto parseFromString(std::string_view cfg_string, std::string_view source = "unknown")
-    -> Reader {
-  return Parser::parseFromString(cfg_string, source);
+inline auto parseFromString(std::string_view cfg_string, std::string_view source = "unknown",
+                            ParseStats* stats = nullptr) -> Reader {
+  return Parser::parseFromString(cfg_string, source, stats);
 }
 
 }  // namespace flexi_cfg
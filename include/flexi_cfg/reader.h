@@ -2,15 +2,28 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "flexi_cfg/config/classes.h"
 #include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/config/frozen.h"
 #include "flexi_cfg/config/helpers.h"
+#include "flexi_cfg/fields.h"
 #include "flexi_cfg/logger.h"
 #include "flexi_cfg/utils.h"
 #include "flexi_cfg/visitor-internal.h"
@@ -35,16 +48,34 @@ class Reader {
   /// \brief Prints the full config to the stream
   void dump(std::ostream& os) const;
 
+  /// \brief Builds a compact, read-only copy of the config that is used for all subsequent reads
+  ///        (including by any readers obtained from this one). Every key is indexed, so `exists`,
+  ///        `getType` & `getValue` are a single hash lookup (without any allocation). This is
+  ///        opt-in, as it is only worthwhile when the config is read many times.
+  /// \note A reader obtained from a frozen reader (i.e. `getValue<Reader>`) is a view of the same
+  ///       frozen copy: creating one is a single lookup, and nothing is copied or locked.
+  /// \note Any number of threads may read from a frozen reader (and the readers & keys obtained
+  ///       from it) at once. Reads never lock, and reading a number, bool or `std::string_view`
+  ///       (or a `std::array` of them) doesn't allocate either. Only results that own memory (e.g.
+  ///       `std::string` & `std::vector`) and the exceptions thrown for invalid keys allocate.
+  void freeze();
+
+  /// \brief Checks if `freeze` has been called (on this reader or the reader it came from)
+  [[nodiscard]] auto frozen() const -> bool { return frozen_ != nullptr; }
+
   /// \brief Walks the full config tree
   template <visitor::TypedVisitor Visitor>
   void visit(Visitor& visitor) const {
-    return visitor::internal::visitStruct(cfg_data_, visitor);
+    if (frozen_) {
+      return visitor::internal::visitStruct(*frozen_, root_, visitor);
+    }
+    return visitor::internal::visitStruct(*cfg_data_, visitor);
   }
 
   /// \brief Checks if an entry with the provided key exists
   /// \param[in] key The name of the key of interest
   /// \return True if the key exists
-  [[nodiscard]] auto exists(const std::string& key) const -> bool;
+  [[nodiscard]] auto exists(std::string_view key) const -> bool;
 
   /// \brief Provides the keys for the first level of the config structure
   /// \return A vector keys
@@ -53,82 +84,528 @@ class Reader {
   /// \brief Provides the type of the value associated with the given key
   /// \param[in] key The name of the key of interest
   /// \return The type of the value associated with the key
-  [[nodiscard]] auto getType(const std::string& key) const -> config::types::Type;
+  [[nodiscard]] auto getType(std::string_view key) const -> config::types::Type;
 
   /// \brief Accessor to the value of the given key (if it exists)
   /// \param[in] key The name of the key of interest
   /// \return The value of the key
+  /// \note A `std::string_view` refers to storage owned by the reader (and shared with its copies
+  ///       and any readers obtained from it). It is only valid while one of them exists.
   template <typename T>
-  auto getValue(const std::string& key) const -> T;
+  auto getValue(std::string_view key) const -> T;
 
   /// \brief Accessor to the value of the given key (if it exists)
   /// \param[in] key The name of the key of interest
   /// \param[out] value The value of the key
   template <typename T>
-  void getValue(const std::string& key, T& value) const;
+  void getValue(std::string_view key, T& value) const;
 
   template <typename T>
-  void getValue(const std::string& key, std::vector<T>& value) const;
+  void getValue(std::string_view key, std::vector<T>& value) const;
 
   template <typename T, size_t N>
-  void getValue(const std::string& key, std::array<T, N>& value) const;
+  void getValue(std::string_view key, std::array<T, N>& value) const;
+
+  /// \brief A key used to read the same value repeatedly. A key obtained from `Reader::key` also
+  ///        refers directly to the value, so reading it (from that reader) doesn't require any
+  ///        lookup at all.
+  class Key {
+   public:
+    explicit Key(std::string key) : key_{std::move(key)} {}
+
+    [[nodiscard]] auto str() const -> const std::string& { return key_; }
+
+   private:
+    friend class Reader;
+
+    std::string key_;
+    // The node this key refers to, as resolved by the reader that created it. Holding on to that
+    // reader's config ensures the node (or index) can't refer to a different config.
+    std::shared_ptr<const config::types::CfgMap> data_{};
+    config::types::BasePtr node_{};
+    std::shared_ptr<const config::types::FrozenCfg> cfg_{};
+    config::types::FrozenCfg::Index root_{config::types::FrozenCfg::root};
+    config::types::FrozenCfg::Index idx_{config::types::FrozenCfg::root};
+  };
+
+  /// \brief A `Key` whose value is known to be convertible to `T`. The value is converted once,
+  ///        when the key is created, so reading it (from that reader) is just a copy.
+  template <typename T>
+  class TypedKey : public Key {
+   public:
+    using value_type = T;
+
+   private:
+    friend class Reader;
+    TypedKey(Key key, T value) : Key{std::move(key)}, value_{std::move(value)} {}
+
+    T value_{};
+  };
+
+  /// \brief Creates a handle for the given key. The key must exist.
+  /// \param[in] key The name of the key of interest
+  /// \return A handle that can be passed to `getValue`
+  [[nodiscard]] auto key(std::string key) const -> Key;
+
+  /// \brief Creates a handle for the given key, checking that the value can be read as a `T`.
+  /// \param[in] key The name of the key of interest
+  /// \return A handle that can be passed to `getValue`
+  template <typename T>
+  [[nodiscard]] auto key(std::string key) const -> TypedKey<T>;
+
+  /// \brief Accessor to the value of the given key (if it exists)
+  /// \param[in] key A handle for the key of interest (see `Reader::key`)
+  /// \return The value of the key
+  template <typename T>
+  auto getValue(const Key& key) const -> T;
+
+  template <typename T>
+  auto getValue(const TypedKey<T>& key) const -> T;
+
+  /// \brief Accessor to the value of the given key (if it exists)
+  /// \param[in] key A handle for the key of interest (see `Reader::key`)
+  /// \param[out] value The value of the key
+  template <typename T>
+  void getValue(const Key& key, T& value) const;
+
+  template <typename T>
+  void getValue(const Key& key, std::vector<T>& value) const;
+
+  template <typename T, size_t N>
+  void getValue(const Key& key, std::array<T, N>& value) const;
+
+  /// \brief The size of each dimension of a (nested) list, outermost first
+  using Shape = std::vector<std::size_t>;
+
+  /// \brief Provides the shape of a (nested) list. All of the lists at the same depth must have
+  ///        the same size.
+  /// \param[in] key The name of the key of interest
+  /// \return The size of each dimension of the list
+  [[nodiscard]] auto getShape(std::string_view key) const -> Shape;
+
+  /// \brief Reads all of the numbers in a (nested) list into a single buffer, in row-major order.
+  ///        This is much cheaper than `getValue<std::vector<T>>` for large lists.
+  /// \param[in] key The name of the key of interest
+  /// \param[out] shape The shape of the list (optional)
+  /// \return The values of the list
+  template <typename T>
+    requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+  auto getValues(std::string_view key, Shape* shape = nullptr) const -> std::vector<T>;
+
+  /// \brief Reads all of the numbers in a (nested) list into the provided buffer, in row-major
+  ///        order. The size of the buffer must match the number of values in the list.
+  /// \param[in] key The name of the key of interest
+  /// \param[out] values The values of the list
+  template <typename T>
+    requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+  void getValues(std::string_view key, std::span<T> values) const;
+
+  /// \brief Populates a struct whose fields are declared with `FLEXI_CFG_FIELDS`. The struct-like
+  ///        object at `key` is looked up once, after which each field is read directly from it.
+  ///        Every field is read, so all of the missing or mistyped fields are reported together.
+  /// \param[in] key The name of the struct-like object of interest
+  /// \return The populated struct
+  template <Bindable T>
+  [[nodiscard]] auto bind(std::string_view key) const -> T;
+
+  template <Bindable T>
+  void bind(std::string_view key, T& value) const;
 
   /// \brief Provides a list of all structs containing the specified key
   /// \param[in] key The name of the key to search for recursively within all structs
   /// \return A vector of keys for all structs containing 'key'
-  [[nodiscard]] auto findStructsWithKey(const std::string& key) const -> std::vector<std::string>;
+  [[nodiscard]] auto findStructsWithKey(std::string_view key) const -> std::vector<std::string>;
 
  protected:
-  [[nodiscard]] auto getNestedConfig(const std::string& key) const
-      -> std::pair<std::string, const config::types::CfgMap&>;
+  [[nodiscard]] auto getNestedConfig(std::string_view key) const
+      -> std::pair<std::string_view, const config::types::CfgMap&>;
 
   /// \note: This method is here in order to enable the python bindings to more easily parse list
   /// types
-  [[nodiscard]] auto getCfgMap() const -> const config::types::CfgMap& { return cfg_data_; }
+  [[nodiscard]] auto getCfgMap() const -> const config::types::CfgMap& { return *cfg_data_; }
 
   static void convert(const config::types::ValuePtr& value_ptr, float& value);
   static void convert(const config::types::ValuePtr& value_ptr, double& value);
+  static void convert(const config::types::ValuePtr& value_ptr, int8_t& value);
+  static void convert(const config::types::ValuePtr& value_ptr, int16_t& value);
   static void convert(const config::types::ValuePtr& value_ptr, int& value);
   static void convert(const config::types::ValuePtr& value_ptr, int64_t& value);
+  static void convert(const config::types::ValuePtr& value_ptr, uint8_t& value);
+  static void convert(const config::types::ValuePtr& value_ptr, uint16_t& value);
+  static void convert(const config::types::ValuePtr& value_ptr, uint32_t& value);
   static void convert(const config::types::ValuePtr& value_ptr, uint64_t& value);
   static void convert(const config::types::ValuePtr& value_ptr, bool& value);
   static void convert(const config::types::ValuePtr& value_ptr, std::string& value);
+  static void convert(const config::types::ValuePtr& value_ptr, std::string_view& value);
+
+  /// \brief Converts the text of a value. A decoded `number` (see `ConfigValue::number`) is used
+  ///        instead, if it can be represented exactly as the requested type.
+  static void convert(config::types::Type type, std::string_view value_str, float& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, double& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, int8_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, int16_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, int& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, int64_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, uint8_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, uint16_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, uint32_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, uint64_t& value,
+                      const config::types::Number& number = {});
+  static void convert(config::types::Type type, std::string_view value_str, bool& value);
+  /// \note For strings, `value_str` is the text without the quotes (see `ConfigValue::unquoted`)
+  static void convert(config::types::Type type, std::string_view value_str, std::string& value);
+  static void convert(config::types::Type type, std::string_view value_str,
+                      std::string_view& value);
+
+  /// \brief Converts the element at `i` of `list`, reading packed elements without creating a node
+  template <typename T>
+  static void convertElement(const config::types::ConfigList& list, std::size_t i, T& value);
 
  private:
+  using FrozenCfg = config::types::FrozenCfg;
+
+  /// \brief Creates a reader of a map that is shared (e.g. with the reader it was obtained from)
+  Reader(std::shared_ptr<const config::types::CfgMap> cfg, std::string parent);
+
+  [[nodiscard]] static auto emptyCfg() -> const std::shared_ptr<const config::types::CfgMap>& {
+    static const auto empty = std::make_shared<const config::types::CfgMap>();
+    return empty;
+  }
+
   template <typename T>
   static void convert(const config::types::ValuePtr& value_ptr, std::vector<T>& value);
   template <typename T, size_t N>
   static void convert(const config::types::ValuePtr& value_ptr, std::array<T, N>& value);
 
-  void getValue(const std::string& key, Reader& reader) const;
+  template <typename T>
+  static void convert(const FrozenCfg& cfg, FrozenCfg::Index idx, T& value);
+  template <typename T>
+  static void convert(const FrozenCfg& cfg, FrozenCfg::Index idx, std::vector<T>& value);
+  template <typename T, size_t N>
+  static void convert(const FrozenCfg& cfg, FrozenCfg::Index idx, std::array<T, N>& value);
+
+  void getValue(std::string_view key, Reader& reader) const;
+  void getValue(const Key& key, Reader& reader) const { getValue(key.str(), reader); }
+
+  // The lookups shared by the `getValue` overloads for plain strings & `Key`s
+  [[nodiscard]] static auto name(std::string_view key) -> std::string_view { return key; }
+  [[nodiscard]] static auto name(const Key& key) -> std::string_view { return key.str(); }
+  [[nodiscard]] auto index(std::string_view key) const -> FrozenCfg::Index;
+  [[nodiscard]] auto index(const Key& key) const -> FrozenCfg::Index;
+  [[nodiscard]] auto lookup(std::string_view key) const -> config::types::BasePtr;
+  [[nodiscard]] auto lookup(const Key& key) const -> config::types::BasePtr;
+  /// \brief Whether `key` was created by this reader (or a copy of it)
+  [[nodiscard]] auto owns(const Key& key) const -> bool;
+
+  /// \brief Finds a list. Exactly one of `node` and `idx` (for frozen readers) is set.
+  struct ListRef {
+    const config::types::ConfigBase* node{nullptr};
+    std::optional<FrozenCfg::Index> idx{};
+  };
+  [[nodiscard]] auto list(std::string_view key) const -> ListRef;
+  [[nodiscard]] auto shape(const ListRef& list) const -> Shape;
+
+  template <typename T>
+  static void flatten(const config::types::ConfigBase& node, T*& out);
+  template <typename T>
+  static void flatten(const FrozenCfg& cfg, FrozenCfg::Index idx, T*& out);
+  /// \brief Reads a list into the buffer returned by `buffer(size)`
+  template <typename T, typename Buffer>
+  void readValues(std::string_view key, Shape& shape, Buffer&& buffer) const;
 
-  // All of the config data!
-  config::types::CfgMap cfg_data_;
+  /// \brief Populates `value` (a `Bindable` struct or anything else that can be read) from a node.
+  ///        Any errors are added to `errors` (prefixed by `name`) rather than thrown.
+  template <typename T>
+  static void bindValue(const config::types::BasePtr& node, const std::string& name, T& value,
+                        std::vector<std::string>& errors);
+  template <typename T>
+  static void bindValue(const FrozenCfg& cfg, FrozenCfg::Index idx, const std::string& name,
+                        T& value, std::vector<std::string>& errors);
+
+  template <typename K, typename T>
+  void read(const K& key, T& value) const;
+  template <typename K, typename T>
+  void read(const K& key, std::vector<T>& value) const;
+  template <typename K, typename T, size_t N>
+  void read(const K& key, std::array<T, N>& value) const;
+
+  // All of the config data! It is never modified, so it is shared by all copies of the reader and
+  // by the readers obtained from it (which refer to a struct within it).
+  std::shared_ptr<const config::types::CfgMap> cfg_data_{emptyCfg()};
   // Store the name of the parent struct for debugging/printing
   std::string parent_name_;
+
+  // The frozen copy of the config (see `freeze`) and the index of this reader's struct within it.
+  std::shared_ptr<const FrozenCfg> frozen_{};
+  FrozenCfg::Index root_{FrozenCfg::root};
 };
 
 template <typename T>
-auto Reader::getValue(const std::string& key) const -> T {
+auto Reader::getValue(std::string_view key) const -> T {
+  T value{};
+  getValue(key, value);
+  return value;
+}
+
+template <typename T>
+void Reader::getValue(std::string_view key, T& value) const {
+  read(key, value);
+}
+
+template <typename T>
+void Reader::getValue(std::string_view key, std::vector<T>& value) const {
+  read(key, value);
+}
+
+template <typename T, size_t N>
+void Reader::getValue(std::string_view key, std::array<T, N>& value) const {
+  read(key, value);
+}
+
+template <typename T>
+auto Reader::key(std::string key) const -> TypedKey<T> {
+  auto handle = this->key(std::move(key));
+  // The config is never modified, so the value is read (and any type errors reported) only once.
+  auto value = getValue<T>(handle);
+  return TypedKey<T>{std::move(handle), std::move(value)};
+}
+
+template <typename T>
+auto Reader::getValue(const Key& key) const -> T {
   T value{};
   getValue(key, value);
   return value;
 }
 
 template <typename T>
-void Reader::getValue(const std::string& key, T& value) const {
-  // Split the key into parts
-  const auto keys = utils::split(key, '.');
+auto Reader::getValue(const TypedKey<T>& key) const -> T {
+  if (owns(key)) {
+    return key.value_;
+  }
+  return getValue<T>(static_cast<const Key&>(key));
+}
+
+template <typename T>
+void Reader::getValue(const Key& key, T& value) const {
+  read(key, value);
+}
+
+template <typename T>
+void Reader::getValue(const Key& key, std::vector<T>& value) const {
+  read(key, value);
+}
+
+template <typename T, size_t N>
+void Reader::getValue(const Key& key, std::array<T, N>& value) const {
+  read(key, value);
+}
 
+template <typename T>
+  requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+auto Reader::getValues(std::string_view key, Shape* shape) const -> std::vector<T> {
+  Shape list_shape{};
+  std::vector<T> values;
+  readValues<T>(key, list_shape, [&values](std::size_t size) {
+    values.resize(size);
+    return std::span<T>(values);
+  });
+  if (shape != nullptr) {
+    *shape = std::move(list_shape);
+  }
+  return values;
+}
+
+template <typename T>
+  requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+void Reader::getValues(std::string_view key, std::span<T> values) const {
+  Shape shape{};
+  readValues<T>(key, shape, [&key, values](std::size_t size) {
+    if (size != values.size()) {
+      THROW_EXCEPTION(config::Exception, "Expected {} entries in '{}', but found {}!",
+                      values.size(), key, size);
+    }
+    return values;
+  });
+}
+
+template <typename T, typename Buffer>
+void Reader::readValues(std::string_view key, Shape& shape, Buffer&& buffer) const {
+  try {
+    const auto ref = list(key);
+    shape = this->shape(ref);
+    const auto values = std::forward<Buffer>(buffer)(
+        std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies{}));
+    T* out = values.data();
+    if (ref.idx) {
+      flatten(*frozen_, *ref.idx, out);
+    } else {
+      flatten(*ref.node, out);
+    }
+  } catch (config::Exception& e) {
+    e.prepend(fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, key)));
+    throw;
+  }
+}
+
+template <typename T>
+void Reader::flatten(const config::types::ConfigBase& node, T*& out) {
+  if (node.type == config::types::Type::kList) {
+    const auto& list = dynamic_cast<const config::types::ConfigList&>(node);
+    if (const auto* packed = list.packed(); packed != nullptr) {
+      if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
+                    std::is_same_v<T, double>) {
+        // Nothing to convert, so the elements are copied as is.
+        if (const auto* values = std::get_if<std::vector<T>>(&packed->values())) {
+          out = std::ranges::copy(*values, out).out;
+          return;
+        }
+      }
+      for (std::size_t i = 0; i < packed->size(); ++i) {
+        convert(packed->type(), packed->text(i), *out++, packed->number(i));
+      }
+      return;
+    }
+    for (const auto& element : list.nodes()) {
+      flatten(*element, out);
+    }
+    return;
+  }
+  const auto* value = dynamic_cast<const config::types::ConfigValue*>(&node);
+  if (value == nullptr) {
+    THROW_EXCEPTION(config::InvalidTypeException, "Expected a value, but got '{}' type.",
+                    node.type);
+  }
+  convert(value->type, value->value, *out++, value->number);
+}
+
+template <typename T>
+void Reader::flatten(const FrozenCfg& cfg, FrozenCfg::Index idx, T*& out) {
+  if (cfg.type(idx) == config::types::Type::kList) {
+    for (const auto child : cfg.children(idx)) {
+      flatten(cfg, child, out);
+    }
+    return;
+  }
+  convert(cfg, idx, *out++);
+}
+
+template <Bindable T>
+auto Reader::bind(std::string_view key) const -> T {
+  T value{};
+  bind(key, value);
+  return value;
+}
+
+template <Bindable T>
+void Reader::bind(std::string_view key, T& value) const {
+  const auto name = utils::makeName(parent_name_, key);
+  std::vector<std::string> errors;
+  try {
+    if (frozen_) {
+      bindValue(*frozen_, index(key), name, value, errors);
+    } else {
+      bindValue(lookup(key), name, value, errors);
+    }
+  } catch (config::Exception& e) {
+    e.prepend(fmt::format("[Error] While reading '{}':\n", name));
+    throw;
+  }
+  if (!errors.empty()) {
+    THROW_EXCEPTION(config::InvalidConfigException,
+                    "[Error] While binding '{}', {} field(s) are missing or invalid:\n{}", name,
+                    errors.size(), utils::join(errors, "\n"));
+  }
+}
+
+template <typename T>
+void Reader::bindValue(const config::types::BasePtr& node, const std::string& name, T& value,
+                       std::vector<std::string>& errors) {
+  try {
+    if constexpr (Bindable<T>) {
+      const auto struct_like = dynamic_pointer_cast<config::types::ConfigStructLike>(node);
+      if (struct_like == nullptr) {
+        THROW_EXCEPTION(config::InvalidTypeException,
+                        "Expected a struct-like object, but got '{}' type.", node->type);
+      }
+      const auto bind_field = [&](const auto& field) {
+        const auto it = struct_like->data.find(field.name);
+        const auto field_name = utils::makeName(name, field.name);
+        if (it == struct_like->data.end()) {
+          errors.push_back(
+              fmt::format("'{}': Unable to find '{}' in '{}'!", field_name, field.name, name));
+          return;
+        }
+        bindValue(it->second, field_name, value.*field.member, errors);
+      };
+      static constexpr auto kFields = details::fields<T>();
+      std::apply([&bind_field](const auto&... field) { (bind_field(field), ...); }, kFields);
+    } else {
+      const auto value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(node);
+      if (value_ptr == nullptr) {
+        THROW_EXCEPTION(config::InvalidTypeException, "Expected a value, but got '{}' type.",
+                        node->type);
+      }
+      convert(value_ptr, value);
+    }
+  } catch (const std::exception& e) {
+    errors.push_back(fmt::format("'{}': {}", name, e.what()));
+  }
+}
+
+template <typename T>
+void Reader::bindValue(const FrozenCfg& cfg, FrozenCfg::Index idx, const std::string& name,
+                       T& value, std::vector<std::string>& errors) {
+  try {
+    if constexpr (Bindable<T>) {
+      if (!cfg.isStructLike(idx)) {
+        THROW_EXCEPTION(config::InvalidTypeException,
+                        "Expected a struct-like object, but got '{}' type.", cfg.type(idx));
+      }
+      const auto bind_field = [&](const auto& field) {
+        const auto child = cfg.find(idx, field.name);
+        const auto field_name = utils::makeName(name, field.name);
+        if (!child) {
+          errors.push_back(
+              fmt::format("'{}': Unable to find '{}' in '{}'!", field_name, field.name, name));
+          return;
+        }
+        bindValue(cfg, *child, field_name, value.*field.member, errors);
+      };
+      static constexpr auto kFields = details::fields<T>();
+      std::apply([&bind_field](const auto&... field) { (bind_field(field), ...); }, kFields);
+    } else {
+      convert(cfg, idx, value);
+    }
+  } catch (const std::exception& e) {
+    errors.push_back(fmt::format("'{}': {}", name, e.what()));
+  }
+}
+
+template <typename K, typename T>
+void Reader::read(const K& key, T& value) const {
   try {
-    const auto cfg_val = config::helpers::getConfigValue(cfg_data_, keys);
+    if (frozen_) {
+      convert(*frozen_, index(key), value);
+      return;
+    }
+    const auto cfg_val = lookup(key);
 
     const auto value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(cfg_val);
     convert(value_ptr, value);
     logger::debug(" -- Type is {}", typeid(T).name());
   } catch (config::Exception& e) {
     // Catch and re-throw with extra information to aid in debugging.
-    e.prepend(fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, key)));
+    e.prepend(
+        fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, name(key))));
     throw;
   }
 }
@@ -145,12 +622,12 @@ void Reader::convert(const std::shared_ptr<config::types::ConfigValue>& value_pt
     THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
                     config::types::Type::kList, value_ptr->type);
   }
-  logger::debug("List values: '[{}]'", fmt::join(list_ptr->data, ", "));
+  logger::debug("List values: '{}'", list_ptr);
 
-  for (const auto& e : list_ptr->data) {
-    const auto list_value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(e);
+  value.reserve(value.size() + list_ptr->size());
+  for (std::size_t i = 0; i < list_ptr->size(); ++i) {
     T v{};
-    convert(list_value_ptr, v);
+    convertElement(*list_ptr, i, v);
     value.emplace_back(v);
   }
 }
@@ -166,32 +643,92 @@ void Reader::convert(const std::shared_ptr<config::types::ConfigValue>& value_pt
     THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
                     config::types::Type::kList, value_ptr->type);
   }
-  logger::debug("List values: '[{}]'", fmt::join(list_ptr->data, ", "));
+  logger::debug("List values: '{}'", list_ptr);
 
-  if (list_ptr->data.size() != N) {
+  if (list_ptr->size() != N) {
     THROW_EXCEPTION(config::Exception, "Expected {} entries in '{}', but found {}!", N, value_ptr,
-                    list_ptr->data.size());
+                    list_ptr->size());
   }
 
   for (size_t i = 0; i < N; ++i) {
-    const auto list_value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(list_ptr->data[i]);
-    convert(list_value_ptr, value[i]);
+    convertElement(*list_ptr, i, value[i]);
+  }
+}
+
+template <typename T>
+void Reader::convertElement(const config::types::ConfigList& list, std::size_t i, T& value) {
+  const auto* packed = list.packed();
+  if (packed == nullptr) {
+    convert(dynamic_pointer_cast<config::types::ConfigValue>(list.nodes().at(i)), value);
+  } else if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+    convert(packed->type(), packed->text(i), value, packed->number(i));
+  } else if constexpr (requires { convert(packed->type(), packed->text(i), value); }) {
+    convert(packed->type(), packed->text(i), value);
+  } else {
+    // The elements of a packed list are never lists (or structs) themselves.
+    THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
+                    config::types::Type::kList, packed->type());
+  }
+}
+
+template <typename T>
+void Reader::convert(const FrozenCfg& cfg, FrozenCfg::Index idx, T& value) {
+  if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+    convert(cfg.type(idx), cfg.value(idx), value, cfg.number(idx));
+  } else {
+    convert(cfg.type(idx), cfg.value(idx), value);
   }
 }
 
 template <typename T>
-void Reader::getValue(const std::string& key, std::vector<T>& value) const {
-  // Split the key into parts
-  const auto keys = utils::split(key, '.');
+void Reader::convert(const FrozenCfg& cfg, FrozenCfg::Index idx, std::vector<T>& value) {
+  if (cfg.type(idx) != config::types::Type::kList) {
+    THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
+                    config::types::Type::kList, cfg.type(idx));
+  }
+  for (const auto child : cfg.children(idx)) {
+    T v{};
+    convert(cfg, child, v);
+    value.emplace_back(v);
+  }
+}
+
+template <typename T, size_t N>
+void Reader::convert(const FrozenCfg& cfg, FrozenCfg::Index idx, std::array<T, N>& value) {
+  if (cfg.type(idx) != config::types::Type::kList) {
+    THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
+                    config::types::Type::kList, cfg.type(idx));
+  }
+  const auto children = cfg.children(idx);
+  if (children.size() != N) {
+    THROW_EXCEPTION(config::Exception, "Expected {} entries in '{}', but found {}!", N,
+                    cfg.str(idx), children.size());
+  }
+  for (size_t i = 0; i < N; ++i) {
+    convert(cfg, children[i], value[i]);
+  }
+}
 
+template <typename K, typename T>
+void Reader::read(const K& key, std::vector<T>& value) const {
   try {
-    const auto cfg_val = config::helpers::getConfigValue(cfg_data_, keys);
+    if (frozen_) {
+      const auto idx = index(key);
+      if (frozen_->type(idx) != config::types::Type::kList) {
+        THROW_EXCEPTION(config::InvalidTypeException,
+                        "Expected '{}' to contain a list, but is of type {}",
+                        utils::makeName(parent_name_, name(key)), frozen_->type(idx));
+      }
+      convert(*frozen_, idx, value);
+      return;
+    }
+    const auto cfg_val = lookup(key);
 
     // Ensure this is a list if the user is asking for a list.
     if (cfg_val->type != config::types::Type::kList) {
       THROW_EXCEPTION(config::InvalidTypeException,
                       "Expected '{}' to contain a list, but is of type {}",
-                      utils::makeName(parent_name_, key), cfg_val->type);
+                      utils::makeName(parent_name_, name(key)), cfg_val->type);
     }
     logger::debug("Reading vector of type: {}", typeid(T).name());
 
@@ -199,31 +736,40 @@ void Reader::getValue(const std::string& key, std::vector<T>& value) const {
     convert(value_ptr, value);
   } catch (config::Exception& e) {
     // Catch and re-throw with extra information to aid in debugging.
-    e.prepend(fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, key)));
+    e.prepend(
+        fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, name(key))));
     throw;
   }
 }
 
-template <typename T, size_t N>
-void Reader::getValue(const std::string& key, std::array<T, N>& value) const {
-  // Split the key into parts
-  const auto keys = utils::split(key, '.');
-
+template <typename K, typename T, size_t N>
+void Reader::read(const K& key, std::array<T, N>& value) const {
   try {
-    const auto cfg_val = config::helpers::getConfigValue(cfg_data_, keys);
+    if (frozen_) {
+      const auto idx = index(key);
+      if (frozen_->type(idx) != config::types::Type::kList) {
+        THROW_EXCEPTION(config::InvalidTypeException,
+                        "Expected '{}' to contain a list, but is of type {}",
+                        utils::makeName(parent_name_, name(key)), frozen_->type(idx));
+      }
+      convert(*frozen_, idx, value);
+      return;
+    }
+    const auto cfg_val = lookup(key);
 
     // Ensure this is a list if the user is asking for a list.
     if (cfg_val->type != config::types::Type::kList) {
       THROW_EXCEPTION(config::InvalidTypeException,
                       "Expected '{}' to contain a list, but is of type {}",
-                      utils::makeName(parent_name_, key), cfg_val->type);
+                      utils::makeName(parent_name_, name(key)), cfg_val->type);
     }
     logger::debug("Reading array of type: {}", typeid(T).name());
 
     const auto& value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(cfg_val);
     convert(value_ptr, value);
   } catch (config::Exception& e) {
-    e.prepend(fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, key)));
+    e.prepend(
+        fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, name(key))));
     throw;
   }
 }
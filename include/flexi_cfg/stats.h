@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace flexi_cfg {
+
+/// \brief Timing & counters collected while parsing a config. Collection is opt-in (see
+///        `Parser::parse`) and is cheap enough to leave enabled in production.
+struct ParseStats {
+  using Duration = std::chrono::nanoseconds;
+
+  /// Wall time of the whole parse (PEG parse + resolve)
+  Duration total{};
+  /// Wall time of the PEG parse of all files
+  Duration parse{};
+  /// Wall time of each phase of `Parser::resolveConfig`, in the order in which they were run
+  std::vector<std::pair<std::string, Duration>> phases;
+  /// Wall time of the PEG parse of each file, in the order in which parsing completed. The time of
+  /// a file includes the time spent parsing any files it includes, unless the files were parsed
+  /// concurrently (see `Parser::parse`).
+  std::vector<std::pair<std::string, Duration>> files;
+
+  /// Number of config nodes created (including clones)
+  std::size_t nodes_created{0};
+  /// Maximum number of config nodes alive at any one time during the parse
+  std::size_t peak_nodes{0};
+  /// Number of clones performed when creating a struct from a reference & proto
+  std::size_t clones{0};
+  /// Number of variables (i.e. `$VAR` or `${VAR}`) replaced within strings
+  std::size_t var_substitutions{0};
+  /// Number of expressions evaluated
+  std::size_t expressions_evaluated{0};
+};
+
+}  // namespace flexi_cfg
+
+namespace flexi_cfg::config::stats {
+
+namespace internal {
+struct State {
+  ParseStats* stats{nullptr};
+  std::int64_t live_nodes{0};
+};
+
+inline auto state() -> State& {
+  thread_local State state_s;
+  return state_s;
+}
+}  // namespace internal
+
+/// \brief The stats being collected by the current thread, or `nullptr` if not collecting.
+inline auto active() -> ParseStats* { return internal::state().stats; }
+
+/// \brief Collects stats on the current thread into `stats` for the lifetime of this object.
+///        Passing `nullptr` leaves the current collector (if any) in place.
+class ScopedCollector {
+ public:
+  explicit ScopedCollector(ParseStats* stats) : previous_{internal::state()} {
+    if (stats != nullptr) {
+      internal::state() = {stats, 0};
+    }
+  }
+  ~ScopedCollector() { internal::state() = previous_; }
+
+  ScopedCollector(const ScopedCollector&) = delete;
+  auto operator=(const ScopedCollector&) -> ScopedCollector& = delete;
+  ScopedCollector(ScopedCollector&&) = delete;
+  auto operator=(ScopedCollector&&) -> ScopedCollector& = delete;
+
+ private:
+  internal::State previous_;
+};
+
+/// \brief Increment one of the counters of the active stats (if any).
+inline void count(std::size_t ParseStats::*counter, std::size_t n = 1) {
+  if (auto* stats = active(); stats != nullptr) {
+    stats->*counter += n;
+  }
+}
+
+inline void nodeCreated() {
+  auto& state = internal::state();
+  if (state.stats != nullptr) {
+    ++state.stats->nodes_created;
+    ++state.live_nodes;
+    if (state.live_nodes > static_cast<std::int64_t>(state.stats->peak_nodes)) {
+      state.stats->peak_nodes = static_cast<std::size_t>(state.live_nodes);
+    }
+  }
+}
+
+inline void nodeDestroyed() {
+  auto& state = internal::state();
+  if (state.stats != nullptr) {
+    --state.live_nodes;
+  }
+}
+
+/// \brief The number of nodes created (and not yet destroyed) while collecting on the current
+///        thread.
+inline auto liveNodes() -> std::int64_t { return internal::state().live_nodes; }
+
+/// \brief Adds stats collected on another thread to the active stats (if any).
+/// \param[in] other - The stats collected by the other thread
+/// \param[in] live_nodes - The number of nodes created by the other thread that are still alive
+///                         (see `liveNodes`). These are now counted as live on the current thread.
+inline void merge(const ParseStats& other, std::int64_t live_nodes) {
+  auto& state = internal::state();
+  if (state.stats == nullptr) {
+    return;
+  }
+  auto& stats = *state.stats;
+  stats.files.insert(stats.files.end(), other.files.begin(), other.files.end());
+  stats.nodes_created += other.nodes_created;
+  // At worst, the other thread's peak coincided with all of the nodes currently alive here.
+  const auto live = static_cast<std::size_t>(std::max<std::int64_t>(state.live_nodes, 0));
+  stats.peak_nodes = std::max(stats.peak_nodes, live + other.peak_nodes);
+  stats.clones += other.clones;
+  stats.var_substitutions += other.var_substitutions;
+  stats.expressions_evaluated += other.expressions_evaluated;
+  state.live_nodes += live_nodes;
+}
+
+/// \brief Records the wall time between construction and destruction into `out` (if collecting).
+class ScopedTimer {
+ public:
+  ScopedTimer(std::vector<std::pair<std::string, ParseStats::Duration>> ParseStats::*out,
+              std::string name)
+      : stats_{active()}, out_{out}, name_{std::move(name)} {}
+  ~ScopedTimer() {
+    if (stats_ != nullptr) {
+      (stats_->*out_).emplace_back(std::move(name_), elapsed());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  auto operator=(const ScopedTimer&) -> ScopedTimer& = delete;
+  ScopedTimer(ScopedTimer&&) = delete;
+  auto operator=(ScopedTimer&&) -> ScopedTimer& = delete;
+
+  [[nodiscard]] auto elapsed() const -> ParseStats::Duration {
+    return std::chrono::duration_cast<ParseStats::Duration>(std::chrono::steady_clock::now() -
+                                                            start_);
+  }
+
+ private:
+  ParseStats* stats_;
+  std::vector<std::pair<std::string, ParseStats::Duration>> ParseStats::*out_;
+  std::string name_;
+  std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+};
+
+}  // namespace flexi_cfg::config::stats
@@ -4,6 +4,8 @@
 #include <cxxabi.h>
 #endif
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -11,6 +13,7 @@
 #include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "flexi_cfg/details/type_traits.h"
@@ -36,6 +39,34 @@ inline auto removeSubStr(std::string s, const std::string& sub_str) -> std::stri
   return str;
 }
 
+/// \brief Replaces all (non-overlapping) instances of `from` in `s` with `to`, scanning left to
+///        right. The replacement text is never re-scanned.
+/// \param[in/out] s - The string in which to make the replacements
+/// \param[in] from - The sub-string to replace
+/// \param[in] to - The replacement
+/// \return The number of replacements made
+inline auto replaceAll(std::string& s, std::string_view from, std::string_view to)
+    -> std::size_t {
+  if (from.empty()) {
+    return 0;
+  }
+  auto pos = s.find(from);
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  std::string out;
+  out.reserve(s.size());
+  std::size_t start = 0;
+  std::size_t n = 0;
+  for (; pos != std::string::npos; pos = s.find(from, start), ++n) {
+    out.append(s, start, pos - start).append(to);
+    start = pos + from.size();
+  }
+  out.append(s, start);
+  s = std::move(out);
+  return n;
+}
+
 inline auto split(const std::string& s, char delimiter = '.') -> std::vector<std::string> {
   std::vector<std::string> tokens;
   std::string token;
@@ -46,6 +77,88 @@ inline auto split(const std::string& s, char delimiter = '.') -> std::vector<std
   return tokens;
 }
 
+/// \brief A lazily evaluated `split`: iterating yields the same parts as `split`, but as views into
+///        the original string, so nothing is allocated. The string must outlive the range.
+class SplitView {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = std::string_view;
+
+    iterator() = default;
+
+    auto operator*() const -> std::string_view { return s_.substr(pos_, end_ - pos_); }
+
+    auto operator++() -> iterator& {
+      pos_ = std::min(end_ + 1, s_.size());
+      end_ = std::min(s_.find(delimiter_, pos_), s_.size());
+      return *this;
+    }
+    auto operator++(int) -> iterator {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend auto operator==(const iterator& lhs, const iterator& rhs) -> bool {
+      return lhs.pos_ == rhs.pos_;
+    }
+
+   private:
+    friend class SplitView;
+    iterator(std::string_view s, char delimiter, std::size_t pos)
+        : s_{s},
+          delimiter_{delimiter},
+          pos_{pos},
+          end_{std::min(s.find(delimiter, pos), s.size())} {}
+
+    std::string_view s_{};
+    char delimiter_{'.'};
+    std::size_t pos_{0};
+    std::size_t end_{0};
+  };
+
+  SplitView(std::string_view s, char delimiter) : s_{s}, delimiter_{delimiter} {}
+
+  [[nodiscard]] auto begin() const -> iterator { return {s_, delimiter_, 0}; }
+  [[nodiscard]] auto end() const -> iterator { return {s_, delimiter_, s_.size()}; }
+  [[nodiscard]] auto empty() const -> bool { return s_.empty(); }
+
+  /// \brief The original string, up to (but not including the delimiter before) the part at `it`
+  [[nodiscard]] auto prefix(const iterator& it) const -> std::string_view {
+    return s_.substr(0, it.pos_ == 0 ? 0 : it.pos_ - 1);
+  }
+
+  /// \brief The last part (empty if there are no parts)
+  [[nodiscard]] auto back() const -> std::string_view {
+    if (s_.empty()) {
+      return {};
+    }
+    // A trailing delimiter doesn't start a new part (see `split`).
+    const auto last = s_.back() == delimiter_ ? s_.substr(0, s_.size() - 1) : s_;
+    const auto pos = last.rfind(delimiter_);
+    return pos == std::string_view::npos ? last : last.substr(pos + 1);
+  }
+
+ private:
+  std::string_view s_;
+  char delimiter_;
+};
+
+/// \brief Splits the string on each instance of a delimiter, without allocating
+///
+/// \param[in] s - The input string (which must outlive the result)
+/// \param[in] delimiter - Character on which to split [default='.']
+///
+/// \return A (lazy) range of the parts of `s`
+inline auto splitView(std::string_view s, char delimiter = '.') -> SplitView {
+  return {s, delimiter};
+}
+
 /// \brief Splits the string on the first instance of a delimiter
 ///
 /// \param[in] s - The input string
@@ -87,7 +200,7 @@ inline auto join(const std::vector<std::string>& keys, const std::string& delim)
 }
 
 /// \brief Concatenates two names/labels with the appropriate delimiter
-inline auto makeName(const std::string& n1, const std::string& n2 = "") -> std::string {
+inline auto makeName(std::string_view n1, std::string_view n2 = "") -> std::string {
   // Check that at least one argument is valid. We could just return an empty string, but that seems
   // silly.
   if (n1.empty() && n2.empty()) {
@@ -95,13 +208,16 @@ inline auto makeName(const std::string& n1, const std::string& n2 = "") -> std::
   }
 
   if (n1.empty()) {
-    return n2;
+    return std::string(n2);
   }
   if (n2.empty()) {
-    return n1;
+    return std::string(n1);
   }
 
-  return n1 + "." + n2;
+  std::string name;
+  name.reserve(n1.size() + 1 + n2.size());
+  name.append(n1).append(".").append(n2);
+  return name;
 }
 
 // A generic `contains` method that works for any "iterable" type.
@@ -7,28 +7,53 @@
 #include <range/v3/view.hpp>
 #include <string>
 #include <string_view>
+#include <variant>
 #include <vector>
 
 #include "flexi_cfg/config/classes.h"
+#include "flexi_cfg/config/frozen.h"
 #include "flexi_cfg/logger.h"
 #include "flexi_cfg/utils.h"
 #include "flexi_cfg/visitor.h"
 
 namespace flexi_cfg::visitor::internal {
 
-template <typename T>
-bool tryCast(const std::any& any_val, T& value) {
-  try {
-    value = std::any_cast<T>(any_val);
-    return true;
-  } catch (std::bad_any_cast&) {
-    return false;
-  }
-}
-
 template <TypedVisitor Visitor>
 void visitStruct(const config::types::CfgMap& cfg, Visitor& visitor);
 
+/// \brief Visits the element at `i` of a packed list (without creating a node for it)
+template <TypedVisitor Visitor>
+void visitPackedValue(const std::string& key, const config::types::PackedList& packed,
+                      std::size_t i, Visitor& visitor) {
+  if (packed.type() == config::types::Type::kBoolean) {
+    if constexpr (visitor::BoolValueVisitor<Visitor>) {
+      // matches Reader::convert(..)
+      visitor.onValue(packed.text(i) == "true");
+      return;
+    }
+  } else {
+    const auto number = packed.number(i);
+    if constexpr (visitor::IntValueVisitor<Visitor>) {
+      if (const auto* i_val = std::get_if<int64_t>(&number)) {
+        visitor.onValue(*i_val);
+        return;
+      }
+      if (const auto* ui_val = std::get_if<uint64_t>(&number)) {
+        visitor.onValue(*ui_val);
+        return;
+      }
+    }
+    if constexpr (visitor::FloatValueVisitor<Visitor>) {
+      if (const auto* d_val = std::get_if<double>(&number)) {
+        visitor.onValue(*d_val);
+        return;
+      }
+    }
+  }
+  logger::warn("Visitor, unhandled key: {} -- Type: {} ", key,
+               magic_enum::enum_name(packed.type()));
+}
+
 template <TypedVisitor Visitor>
 void visitValue(const std::string& key, std::shared_ptr<config::types::ConfigBase> cfg_val,
                 Visitor& visitor) {
@@ -37,10 +62,11 @@ void visitValue(const std::string& key, std::shared_ptr<config::types::ConfigBas
       if constexpr (visitor::StringValueVisitor<Visitor>) {
         auto config = std::dynamic_pointer_cast<config::types::ConfigValue>(cfg_val);
         if (config != nullptr) {
-          auto value = config->value;
-          // matches Reader::convert(..)
-          value.erase(std::remove(std::begin(value), std::end(value), '\"'), std::end(value));
-          visitor.onValue(value);
+          if constexpr (requires { visitor.onValue(std::string_view{}); }) {
+            visitor.onValue(config->unquoted());
+          } else {
+            visitor.onValue(std::string(config->unquoted()));
+          }
           break;
         }
       }
@@ -50,58 +76,18 @@ void visitValue(const std::string& key, std::shared_ptr<config::types::ConfigBas
       auto config = std::dynamic_pointer_cast<config::types::ConfigValue>(cfg_val);
       if (config != nullptr) {
         if constexpr (visitor::IntValueVisitor<Visitor>) {
-          if (int8_t i_val; tryCast(config->value_any, i_val)) {
-            visitor.onValue(static_cast<int64_t>(i_val));
-            break;
-          }
-          if (uint8_t ui_val; tryCast(config->value_any, ui_val)) {
-            visitor.onValue(static_cast<uint64_t>(ui_val));
+          if (const auto* i_val = std::get_if<int64_t>(&config->number)) {
+            visitor.onValue(*i_val);
             break;
           }
-          if (int16_t i_val; tryCast(config->value_any, i_val)) {
-            visitor.onValue(static_cast<int64_t>(i_val));
-            break;
-          }
-          if (uint16_t ui_val; tryCast(config->value_any, ui_val)) {
-            visitor.onValue(static_cast<uint64_t>(ui_val));
-            break;
-          }
-          if (int32_t i_val; tryCast(config->value_any, i_val)) {
-            visitor.onValue(static_cast<int64_t>(i_val));
-            break;
-          }
-          if (uint32_t ui_val; tryCast(config->value_any, ui_val)) {
-            visitor.onValue(static_cast<uint64_t>(ui_val));
-            break;
-          }
-          if (int64_t i_val; tryCast(config->value_any, i_val)) {
-            visitor.onValue(i_val);
-            break;
-          }
-          if (uint64_t ui_val; tryCast(config->value_any, ui_val)) {
-            visitor.onValue(ui_val);
-            break;
-          }
-          if (long long i_val; tryCast(config->value_any, i_val)) {
-            visitor.onValue(static_cast<int64_t>(i_val));
-            break;
-          }
-          if (unsigned long long ui_val; tryCast(config->value_any, ui_val)) {
-            visitor.onValue(static_cast<uint64_t>(ui_val));
+          if (const auto* ui_val = std::get_if<uint64_t>(&config->number)) {
+            visitor.onValue(*ui_val);
             break;
           }
         }
         if constexpr (visitor::FloatValueVisitor<Visitor>) {
-          if (float f_val; tryCast(config->value_any, f_val)) {
-            visitor.onValue(f_val);
-            break;
-          }
-          if (double d_val; tryCast(config->value_any, d_val)) {
-            visitor.onValue(d_val);
-            break;
-          }
-          if (long double d_val; tryCast(config->value_any, d_val)) {
-            visitor.onValue(static_cast<double>(d_val));
+          if (const auto* d_val = std::get_if<double>(&config->number)) {
+            visitor.onValue(*d_val);
             break;
           }
         }
@@ -111,8 +97,9 @@ void visitValue(const std::string& key, std::shared_ptr<config::types::ConfigBas
     case config::types::Type::kBoolean: {
       if constexpr (visitor::BoolValueVisitor<Visitor>) {
         auto config = std::dynamic_pointer_cast<config::types::ConfigValue>(cfg_val);
-        if (bool b_val; config != nullptr && tryCast(config->value_any, b_val)) {
-          visitor.onValue(b_val);
+        if (config != nullptr) {
+          // matches Reader::convert(..)
+          visitor.onValue(config->value == "true");
           break;
         }
       }
@@ -134,8 +121,14 @@ void visitValue(const std::string& key, std::shared_ptr<config::types::ConfigBas
         auto config = std::dynamic_pointer_cast<config::types::ConfigList>(cfg_val);
         if (config != nullptr) {
           visitor.beginList();
-          for (auto list_cfg_val : config->data) {
-            visitValue(key, list_cfg_val, visitor);
+          if (const auto* packed = config->packed(); packed != nullptr) {
+            for (std::size_t i = 0; i < packed->size(); ++i) {
+              visitPackedValue(key, *packed, i, visitor);
+            }
+          } else {
+            for (const auto& list_cfg_val : config->nodes()) {
+              visitValue(key, list_cfg_val, visitor);
+            }
           }
           visitor.endList();
           break;
@@ -167,4 +160,83 @@ void visitStruct(const config::types::CfgMap& cfg, Visitor& visitor) {
   }
 }
 
+/// The overloads below walk a `FrozenCfg`. They produce the same sequence of visitor calls as the
+/// overloads above.
+
+template <TypedVisitor Visitor>
+void visitStruct(const config::types::FrozenCfg& cfg, config::types::FrozenCfg::Index idx,
+                 Visitor& visitor);
+
+template <TypedVisitor Visitor>
+void visitValue(std::string_view key, const config::types::FrozenCfg& cfg,
+                config::types::FrozenCfg::Index idx, Visitor& visitor) {
+  const auto type = cfg.type(idx);
+  if (cfg.isStructLike(idx)) {
+    if constexpr (visitor::StructVisitor<Visitor>) {
+      visitStruct(cfg, idx, visitor);
+      return;
+    }
+  } else if (type == config::types::Type::kList) {
+    if constexpr (visitor::ListVisitor<Visitor>) {
+      visitor.beginList();
+      for (const auto child : cfg.children(idx)) {
+        visitValue(key, cfg, child, visitor);
+      }
+      visitor.endList();
+      return;
+    }
+  } else if (type == config::types::Type::kString) {
+    if constexpr (visitor::StringValueVisitor<Visitor>) {
+      if constexpr (requires { visitor.onValue(std::string_view{}); }) {
+        visitor.onValue(cfg.value(idx));
+      } else {
+        visitor.onValue(std::string(cfg.value(idx)));
+      }
+      return;
+    }
+  } else if (type == config::types::Type::kBoolean) {
+    if constexpr (visitor::BoolValueVisitor<Visitor>) {
+      // matches Reader::convert(..)
+      visitor.onValue(cfg.value(idx) == "true");
+      return;
+    }
+  } else {
+    const auto& number = cfg.number(idx);
+    if constexpr (visitor::IntValueVisitor<Visitor>) {
+      if (const auto* i_val = std::get_if<int64_t>(&number)) {
+        visitor.onValue(*i_val);
+        return;
+      }
+      if (const auto* ui_val = std::get_if<uint64_t>(&number)) {
+        visitor.onValue(*ui_val);
+        return;
+      }
+    }
+    if constexpr (visitor::FloatValueVisitor<Visitor>) {
+      if (const auto* d_val = std::get_if<double>(&number)) {
+        visitor.onValue(*d_val);
+        return;
+      }
+    }
+  }
+  logger::warn("Visitor, unhandled key: {} -- Type: {} ", key, magic_enum::enum_name(type));
+}
+
+template <TypedVisitor Visitor>
+void visitStruct(const config::types::FrozenCfg& cfg, config::types::FrozenCfg::Index idx,
+                 Visitor& visitor) {
+  if constexpr (visitor::StructVisitor<Visitor>) {
+    visitor.beginStruct();
+  }
+  for (const auto child : cfg.children(idx)) {
+    if constexpr (visitor::KeyVisitor<Visitor>) {
+      visitor.onKey(std::string(cfg.key(child)));
+    }
+    visitValue(cfg.key(child), cfg, child, visitor);
+  }
+  if constexpr (visitor::StructVisitor<Visitor>) {
+    visitor.endStruct();
+  }
+}
+
 }  // namespace flexi_cfg::visitor::internal
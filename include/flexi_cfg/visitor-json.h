@@ -3,6 +3,7 @@
 #include <fmt/format.h>
 
 #include <string>
+#include <string_view>
 
 #include "flexi_cfg/visitor.h"
 
@@ -11,8 +12,8 @@ namespace flexi_cfg::visitor {
 class JsonVisitor {
  public:
   operator std::string() { return json_; }
-  void onKey(std::string key) { json_ += fmt::format("\"{}\":", key); }
-  void onValue(std::string value) { json_ += fmt::format("\"{}\",", value); }
+  void onKey(std::string_view key) { json_ += fmt::format("\"{}\":", key); }
+  void onValue(std::string_view value) { json_ += fmt::format("\"{}\",", value); }
   void onValue(int64_t value) { json_ += fmt::format("{},", value); }
   void onValue(uint64_t value) { json_ += fmt::format("{},", value); }
   void onValue(double value) { json_ += fmt::format("{},", value); }
@@ -55,12 +56,12 @@ static_assert(FloatValueVisitor<JsonVisitor>);
 class PrettyJsonVisitor {
  public:
   operator std::string() { return json_; }
-  void onKey(std::string key) {
+  void onKey(std::string_view key) {
     updateIndent();
     json_ += fmt::format("{}\"{}\" :", indent_, key);
     indent_ = " ";  // inline value
   }
-  void onValue(std::string value) { json_ += fmt::format("{}\"{}\",\n", indent_, value); }
+  void onValue(std::string_view value) { json_ += fmt::format("{}\"{}\",\n", indent_, value); }
   void onValue(int64_t value) { json_ += fmt::format("{}{},\n", indent_, value); }
   void onValue(uint64_t value) { json_ += fmt::format("{}{},\n", indent_, value); }
   void onValue(double value) { json_ += fmt::format("{}{},\n", indent_, value); }
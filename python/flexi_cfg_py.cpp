@@ -3,8 +3,10 @@
 #include <flexi_cfg/config/helpers.h>
 #include <flexi_cfg/parser.h>
 #include <flexi_cfg/reader.h>
+#include <flexi_cfg/stats.h>
 #include <flexi_cfg/utils.h>
 #include <flexi_cfg/visitor-json.h>
+#include <pybind11/chrono.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl/filesystem.h>
@@ -23,8 +25,7 @@ class ReaderCfgMapAccessor : public Reader {
 
   template <typename T>
   [[nodiscard]] auto getList(const std::string& key) const -> py::list {
-    const auto keys = utils::split(key, '.');
-    const auto& cfg_val = config::helpers::getConfigValue(getCfgMap(), keys);
+    const auto& cfg_val = config::helpers::getConfigValue(getCfgMap(), utils::splitView(key));
     // Ensure this is a list if the user is asking for a list.
     if (cfg_val->type != config::types::Type::kList) {
       THROW_EXCEPTION(config::InvalidTypeException,
@@ -54,7 +55,16 @@ class ReaderCfgMapAccessor : public Reader {
                       config::types::Type::kList);
     }
 
-    for (const auto& e : cfg_list_ptr->data) {
+    if (cfg_list_ptr->packed() != nullptr) {
+      // The elements of a packed list are all values, which are read without creating nodes.
+      for (std::size_t i = 0; i < cfg_list_ptr->size(); ++i) {
+        T v{};
+        convertElement(*cfg_list_ptr, i, v);
+        py_list.append(v);
+      }
+      return;
+    }
+    for (const auto& e : cfg_list_ptr->nodes()) {
       const auto& list_value_ptr = dynamic_pointer_cast<config::types::ConfigValue>(e);
       if (e->type == config::types::Type::kList) {
         py::list new_list;
@@ -194,6 +204,8 @@ PYBIND11_MODULE(flexi_cfg, m) {
           },
           py::arg("pretty")=false)
       .def("dump", [](const flexi_cfg::Reader& r) { r.dump(); })
+      .def("freeze", &flexi_cfg::Reader::freeze)
+      .def("frozen", &flexi_cfg::Reader::frozen)
       .def("exists", &flexi_cfg::Reader::exists)
       .def("keys", &flexi_cfg::Reader::keys)
       .def("get_type", &flexi_cfg::Reader::getType)
@@ -215,15 +227,29 @@ PYBIND11_MODULE(flexi_cfg, m) {
       // Generic accessor
       .def("get_value", &getValueGeneric);
 
+  py::class_<flexi_cfg::ParseStats>(m, "ParseStats")
+      .def(py::init<>())
+      .def_readonly("total", &flexi_cfg::ParseStats::total)
+      .def_readonly("parse", &flexi_cfg::ParseStats::parse)
+      .def_readonly("phases", &flexi_cfg::ParseStats::phases)
+      .def_readonly("files", &flexi_cfg::ParseStats::files)
+      .def_readonly("nodes_created", &flexi_cfg::ParseStats::nodes_created)
+      .def_readonly("peak_nodes", &flexi_cfg::ParseStats::peak_nodes)
+      .def_readonly("clones", &flexi_cfg::ParseStats::clones)
+      .def_readonly("var_substitutions", &flexi_cfg::ParseStats::var_substitutions)
+      .def_readonly("expressions_evaluated", &flexi_cfg::ParseStats::expressions_evaluated);
+
   py::class_<flexi_cfg::Parser>(m, "Parser")
       .def_static("parse", &flexi_cfg::Parser::parse, py::arg("cfg_file"),
-                  py::arg("root_dir") = std::nullopt)
+                  py::arg("root_dir") = std::nullopt, py::arg("stats") = nullptr,
+                  py::arg("threads") = 1)
       .def_static("parse_from_string", &flexi_cfg::Parser::parseFromString, py::arg("cfg_string"),
-                  py::pos_only(), py::arg("source") = "unknown");
+                  py::pos_only(), py::arg("source") = "unknown", py::arg("stats") = nullptr);
 
-  m.def("parse", &flexi_cfg::parse, py::arg("cfg_file"), py::arg("root_dir") = std::nullopt);
+  m.def("parse", &flexi_cfg::parse, py::arg("cfg_file"), py::arg("root_dir") = std::nullopt,
+        py::arg("stats") = nullptr, py::arg("threads") = 1);
   m.def("parse_from_string", &flexi_cfg::parseFromString, py::arg("cfg_string"), py::pos_only(),
-        py::arg("source") = "unknown");
+        py::arg("source") = "unknown", py::arg("stats") = nullptr);
 
   py::class_<Logger> logger_holder(m, "logger");
   py::enum_<flexi_cfg::logger::Severity>(logger_holder, "Severity")
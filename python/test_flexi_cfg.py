@@ -147,5 +147,34 @@ class TestMyConfig(unittest.TestCase):
         cfg = json.loads(cfg_reader.json(pretty=False))
         self.validate_cfg_file(cfg)
 
+    def test_cfg_file_frozen(self):
+        cfg_reader = self.parse_cfg_file()
+        cfg_reader.freeze()
+        self.assertTrue(cfg_reader.frozen())
+        cfg = json.loads(cfg_reader.json())
+        self.validate_cfg_file(cfg)
+
+    def test_parse_stats(self):
+        cfg_file = "config_example5.cfg"
+        try:
+            cfg_file_path = os.path.join(os.environ['EXAMPLES_DIR'], cfg_file)
+        except KeyError:
+            cfg_file_path = os.path.join("../examples", cfg_file)
+        stats = flexi_cfg.ParseStats()
+        cfg = flexi_cfg.parse(cfg_file_path, stats=stats)
+        self.assertTrue(cfg.exists('outer.fl.hx.leg'))
+
+        phases = [name for name, _ in stats.phases]
+        self.assertEqual(phases[0], 'FlattenAndFindProtos')
+        self.assertEqual(phases[-1], 'CleanupConfig')
+        self.assertGreaterEqual(len(stats.files), 2)
+        self.assertGreater(stats.total, stats.parse)
+        self.assertGreater(stats.nodes_created, 0)
+        self.assertGreater(stats.peak_nodes, 0)
+        self.assertLessEqual(stats.peak_nodes, stats.nodes_created)
+        self.assertGreater(stats.clones, 0)
+        self.assertGreater(stats.var_substitutions, 0)
+        self.assertGreater(stats.expressions_evaluated, 0)
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -0,0 +1,312 @@
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flexi_cfg/config/classes.h"
+#include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/config/frozen.h"
+#include "flexi_cfg/utils.h"
+
+namespace {
+
+/// \brief FNV-1a. Used so that a path can be hashed in pieces.
+constexpr std::size_t kFnvOffset{14695981039346656037ULL};
+constexpr std::size_t kFnvPrime{1099511628211ULL};
+
+constexpr auto fnv1a(std::string_view str, std::size_t hash = kFnvOffset) -> std::size_t {
+  for (const auto c : str) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * kFnvPrime;
+  }
+  return hash;
+}
+
+}  // namespace
+
+namespace flexi_cfg::config::types {
+
+FrozenCfg::FrozenCfg(std::shared_ptr<const CfgMap> cfg) : cfg_{std::move(cfg)} {
+  nodes_.push_back({Type::kStruct, 0, 0});
+  keys_.emplace_back();
+  paths_.emplace_back();
+  maps_.emplace_back();
+  freezeChildren(root, *cfg_);
+  buildIndex();
+}
+
+FrozenCfg::FrozenCfg(const FrozenCfg& other)
+    : cfg_{other.cfg_}, nodes_{other.nodes_}, maps_{other.maps_}, numbers_{other.numbers_} {
+  // The strings are owned by the arena of `other`, so they're copied into this one.
+  const auto copy = [this](const std::vector<std::string_view>& from,
+                           std::vector<std::string_view>& to) {
+    to.reserve(from.size());
+    for (const auto str : from) {
+      to.push_back(store(str));
+    }
+  };
+  copy(other.keys_, keys_);
+  copy(other.paths_, paths_);
+  copy(other.values_, values_);
+  buildIndex();
+}
+
+auto FrozenCfg::operator=(const FrozenCfg& other) -> FrozenCfg& {
+  if (this != &other) {
+    *this = FrozenCfg(other);
+  }
+  return *this;
+}
+
+void FrozenCfg::buildIndex() {
+  // NOTE: `index_` refers to the strings in `paths_`, so it can only be built once `paths_` is
+  // complete (and must be rebuilt whenever the strings are copied).
+  index_.clear();
+  index_.reserve(paths_.size());
+  for (Index idx = 0; idx < paths_.size(); ++idx) {
+    if (!paths_[idx].empty()) {
+      index_.emplace(paths_[idx], idx);
+    }
+  }
+}
+
+auto FrozenCfg::store(std::string_view str) -> std::string_view {
+  if (str.empty()) {
+    return {};
+  }
+  auto* data = static_cast<char*>(arena_->allocate(str.size(), alignof(char)));
+  std::ranges::copy(str, data);
+  return {data, str.size()};
+}
+
+auto FrozenCfg::store(std::string_view prefix, std::string_view key) -> std::string_view {
+  if (prefix.empty() || key.empty()) {
+    return store(prefix.empty() ? key : prefix);
+  }
+  const auto size = prefix.size() + 1 + key.size();
+  auto* data = static_cast<char*>(arena_->allocate(size, alignof(char)));
+  auto* end = std::ranges::copy(prefix, data).out;
+  *end++ = '.';
+  std::ranges::copy(key, end);
+  return {data, size};
+}
+
+auto FrozenCfg::isStructLike(Index idx) const -> bool {
+  const auto type = nodes_[idx].type;
+  return type == Type::kStruct || type == Type::kStructInProto || type == Type::kProto ||
+         type == Type::kReference;
+}
+
+auto FrozenCfg::map(Index idx) const -> std::shared_ptr<const CfgMap> {
+  if (!isStructLike(idx)) {
+    THROW_EXCEPTION(InvalidTypeException, "Expected a struct-like object, but got {} type.",
+                    type(idx));
+  }
+  // The map is owned by the tree held in `cfg_`, so it can share ownership of the tree.
+  return {cfg_, maps_[idx]};
+}
+
+auto FrozenCfg::value(Index idx) const -> std::string_view {
+  const auto& node = nodes_[idx];
+  return (isStructLike(idx) || node.type == Type::kList) ? std::string_view{} : values_[node.first];
+}
+
+auto FrozenCfg::number(Index idx) const -> const Number& {
+  static const Number none{};
+  const auto& node = nodes_[idx];
+  return (isStructLike(idx) || node.type == Type::kList) ? none : numbers_[node.first];
+}
+
+auto FrozenCfg::child(Index parent, std::string_view key) const -> std::optional<Index> {
+  if (!isStructLike(parent)) {
+    return std::nullopt;
+  }
+  for (const auto idx : children(parent)) {
+    if (keys_[idx] == key) {
+      return idx;
+    }
+  }
+  return std::nullopt;
+}
+
+auto FrozenCfg::find(Index parent, std::string_view key) const -> std::optional<Index> {
+  if (key.empty()) {
+    return std::nullopt;
+  }
+  if (parent != root && paths_[parent].empty()) {
+    // Structs within lists aren't indexed.
+    std::optional<Index> idx{parent};
+    for (const auto part : utils::splitView(key)) {
+      idx = child(*idx, part);
+      if (!idx) {
+        break;
+      }
+    }
+    return idx;
+  }
+  const auto it = index_.find(Path{paths_[parent], key});
+  return it != index_.end() ? std::optional<Index>{it->second} : std::nullopt;
+}
+
+auto FrozenCfg::find(Index parent, const std::vector<std::string>& keys) const
+    -> std::optional<Index> {
+  std::optional<Index> idx{parent};
+  for (const auto& key : keys) {
+    idx = child(*idx, key);
+    if (!idx) {
+      break;
+    }
+  }
+  return idx;
+}
+
+auto FrozenCfg::get(Index parent, std::string_view key) const -> Index {
+  if (const auto idx = find(parent, key); idx) {
+    return *idx;
+  }
+  // Walk the tree to find where the lookup fails, in order to throw the appropriate exception.
+  return get(parent, utils::split(std::string(key), '.'));
+}
+
+auto FrozenCfg::get(Index parent, const std::vector<std::string>& keys) const -> Index {
+  // NOTE: The error handling here matches `helpers::getNestedConfig` & `helpers::getConfigValue`.
+  std::string rejoined{};
+  Index idx{parent};
+  for (const auto& key : keys | std::views::take(keys.size() - 1)) {
+    const auto child = this->child(idx, key);
+    if (!child) {
+      THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", key, rejoined);
+    }
+    rejoined = utils::makeName(rejoined, key);
+    if (!isStructLike(*child)) {
+      THROW_EXCEPTION(InvalidTypeException,
+                      "Expected value at '{}' to be a struct-like object, but got {} type instead.",
+                      rejoined, type(*child));
+    }
+    idx = *child;
+  }
+
+  const auto child = this->child(idx, keys.back());
+  if (!child) {
+    THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", keys.back(),
+                    utils::join({keys.begin(), keys.end() - 1}, "."));
+  }
+  return *child;
+}
+
+auto FrozenCfg::str(Index idx) const -> std::string {
+  if (isStructLike(idx)) {
+    return fmt::format("struct-like {}", keys_[idx]);
+  }
+  if (type(idx) == Type::kList) {
+    std::vector<std::string> elements;
+    for (const auto child : children(idx)) {
+      elements.emplace_back(str(child));
+    }
+    return fmt::format("[{}]", fmt::join(elements, ", "));
+  }
+  return std::string(value(idx));
+}
+
+void FrozenCfg::freeze(Index idx, const BasePtr& cfg) {
+  // This is the only place where the type of each node is inspected.
+  switch (cfg->type) {
+    case Type::kStruct:
+    case Type::kStructInProto:
+    case Type::kProto:
+    case Type::kReference: {
+      nodes_[idx].type = cfg->type;
+      freezeChildren(idx, dynamic_pointer_cast<ConfigStructLike>(cfg)->data);
+      break;
+    }
+    case Type::kList: {
+      const auto list = dynamic_pointer_cast<ConfigList>(cfg);
+      const auto first = static_cast<Index>(nodes_.size());
+      nodes_[idx] = {Type::kList, first, static_cast<Index>(list->size())};
+      nodes_.resize(nodes_.size() + list->size());
+      keys_.resize(nodes_.size());
+      paths_.resize(nodes_.size());
+      maps_.resize(nodes_.size());
+      if (const auto* packed = list->packed(); packed != nullptr) {
+        // Packed elements are added directly, without creating a node for each of them.
+        for (std::size_t i = 0; i < packed->size(); ++i) {
+          nodes_[first + i] = {packed->type(), static_cast<Index>(values_.size()), 0};
+          values_.push_back(store(packed->text(i)));
+          numbers_.push_back(packed->number(i));
+        }
+        break;
+      }
+      const auto& elements = list->nodes();
+      for (std::size_t i = 0; i < elements.size(); ++i) {
+        freeze(first + static_cast<Index>(i), elements[i]);
+      }
+      break;
+    }
+    default: {
+      nodes_[idx] = {cfg->type, static_cast<Index>(values_.size()), 0};
+      if (const auto value = dynamic_pointer_cast<ConfigValue>(cfg); value != nullptr) {
+        values_.push_back(store(cfg->type == Type::kString ? value->unquoted() : value->value));
+        numbers_.push_back(value->number);
+      } else {
+        // This shouldn't happen once the config is resolved, but keep whatever is there.
+        std::stringstream ss;
+        ss << *cfg;
+        values_.push_back(store(ss.str()));
+        numbers_.emplace_back();
+      }
+      break;
+    }
+  }
+}
+
+void FrozenCfg::freezeChildren(Index idx, const CfgMap& cfg) {
+  // The children are added first so that they are contiguous. Their children are added after.
+  const auto first = static_cast<Index>(nodes_.size());
+  nodes_[idx].first = first;
+  nodes_[idx].size = static_cast<Index>(cfg.size());
+  nodes_.resize(nodes_.size() + cfg.size());
+  keys_.resize(nodes_.size());
+  paths_.resize(nodes_.size());
+  maps_.resize(nodes_.size());
+  maps_[idx] = &cfg;
+  // Only structs that can be reached through other structs are indexed (i.e. not those in lists).
+  const bool indexed = idx == root || !paths_[idx].empty();
+  auto child = first;
+  for (const auto& [key, value] : cfg) {
+    keys_[child] = store(key);
+    if (indexed) {
+      paths_[child] = store(paths_[idx], key);
+    }
+    freeze(child++, value);
+  }
+}
+
+auto FrozenCfg::PathHash::operator()(std::string_view path) const -> std::size_t {
+  return fnv1a(path);
+}
+
+auto FrozenCfg::PathHash::operator()(const Path& path) const -> std::size_t {
+  if (path.prefix.empty()) {
+    return fnv1a(path.key);
+  }
+  return fnv1a(path.key, fnv1a(".", fnv1a(path.prefix)));
+}
+
+auto FrozenCfg::PathEqual::operator()(const Path& lhs, std::string_view rhs) const -> bool {
+  if (lhs.prefix.empty()) {
+    return lhs.key == rhs;
+  }
+  return rhs.size() == lhs.prefix.size() + 1 + lhs.key.size() && rhs.starts_with(lhs.prefix) &&
+         rhs[lhs.prefix.size()] == '.' && rhs.ends_with(lhs.key);
+}
+
+}  // namespace flexi_cfg::config::types
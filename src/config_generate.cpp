@@ -0,0 +1,92 @@
+#include <fmt/color.h>
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "flexi_cfg/generator.h"
+
+namespace {
+
+void usage(std::string_view app) {
+  std::cerr << "usage: " << app << " OUTPUT_DIR [--keys=N] [--OPTION=VALUE ...]\n\n"
+            << "Generates a synthetic config in OUTPUT_DIR. '--keys' selects a realistic mix of\n"
+            << "features for approximately N keys, which may then be adjusted with the options:\n"
+            << "  --seed, --structs, --depth, --keys-per-struct, --protos, --keys-per-proto,\n"
+            << "  --refs-per-proto, --lookups, --expressions, --overrides, --includes, --name\n";
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {  // NOLINT(bugprone-exception-escape)
+  try {
+    std::span<char*> args(argv, argc);
+    const auto app = std::filesystem::path(args[0]).filename().string();
+    if (argc < 2) {
+      std::cerr << "No output directory specified.\n";
+      usage(app);
+      return -1;
+    }
+
+    flexi_cfg::generator::Options options;
+    std::map<std::string, std::string> values;
+    for (const std::string_view arg : args.subspan(2)) {
+      const auto eq = arg.find('=');
+      if (!arg.starts_with("--") || eq == std::string_view::npos) {
+        std::cerr << "Invalid argument: " << arg << "\n";
+        usage(app);
+        return -1;
+      }
+      values[std::string(arg.substr(2, eq - 2))] = std::string(arg.substr(eq + 1));
+    }
+
+    // The seed and key count are applied first, so that the remaining options refine them.
+    const std::uint64_t seed = values.contains("seed") ? std::stoull(values.at("seed")) : 0;
+    if (values.contains("keys")) {
+      options = flexi_cfg::generator::optionsForKeyCount(std::stoull(values.at("keys")), seed);
+    }
+    options.seed = seed;
+    values.erase("seed");
+    values.erase("keys");
+
+    const std::map<std::string, std::reference_wrapper<std::size_t>> size_options{
+        {"structs", options.structs},
+        {"depth", options.depth},
+        {"keys-per-struct", options.keys_per_struct},
+        {"protos", options.protos},
+        {"keys-per-proto", options.keys_per_proto},
+        {"refs-per-proto", options.references_per_proto},
+        {"lookups", options.value_lookups},
+        {"expressions", options.expressions},
+        {"overrides", options.overrides},
+        {"includes", options.include_files}};
+    for (const auto& [key, value] : values) {
+      if (key == "name") {
+        options.name = value;
+      } else if (size_options.contains(key)) {
+        size_options.at(key).get() = std::stoull(value);
+      } else {
+        std::cerr << "Unknown option: --" << key << "\n";
+        usage(app);
+        return -1;
+      }
+    }
+
+    const auto generated = flexi_cfg::generator::generate(options);
+    const auto root = generated.write(std::filesystem::path(args[1]));
+    fmt::print("Generated {} keys in {} file(s). Root config: {}\n", generated.key_count,
+               generated.files.size(), root.string());
+
+    return EXIT_SUCCESS;
+  } catch (const std::exception& e) {
+    fmt::print(fmt::fg(fmt::color::red), "{}\n", e.what());
+    return EXIT_FAILURE;
+  }
+}
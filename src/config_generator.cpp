@@ -0,0 +1,293 @@
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/generator.h"
+
+namespace {
+
+using flexi_cfg::generator::GeneratedConfig;
+using flexi_cfg::generator::Options;
+
+class Generator {
+ public:
+  explicit Generator(const Options& options) : options_(options), rng_(options.seed) {}
+
+  auto run() -> GeneratedConfig {
+    validate();
+
+    const auto n_files = options_.include_files + 1;
+    std::vector<std::string> struct_bodies(options_.structs);
+    for (std::size_t i = 0; i < options_.structs; ++i) {
+      writeStructBody(struct_bodies[i], fmt::format("s{}", i), 1);
+    }
+    if (numeric_keys_.empty() && (options_.value_lookups + options_.expressions) > 0) {
+      THROW_EXCEPTION(std::invalid_argument,
+                      "No numeric keys were generated. Unable to generate lookups or expressions.");
+    }
+    if (options_.overrides > numeric_keys_.size()) {
+      THROW_EXCEPTION(std::invalid_argument,
+                      "Unable to generate {} overrides from only {} numeric keys. Increase the "
+                      "number of structs or keys per struct.",
+                      options_.overrides, numeric_keys_.size());
+    }
+
+    std::vector<std::string> extras(options_.structs);
+    writeReferences(extras);
+    writeLookups(extras);
+    writeExpressions(extras);
+
+    GeneratedConfig generated;
+    generated.files.emplace_back(fmt::format("{}.cfg", options_.name), "");
+    for (std::size_t i = 1; i < n_files; ++i) {
+      generated.files.emplace_back(fmt::format("{}_{}.cfg", options_.name, i), "");
+    }
+
+    auto& root = generated.files.front().second;
+    for (std::size_t i = 1; i < n_files; ++i) {
+      fmt::format_to(std::back_inserter(root), "include {}\n", generated.files[i].first);
+    }
+    writeProtos(root);
+    for (std::size_t i = 0; i < options_.structs; ++i) {
+      auto& out = generated.files[i % n_files].second;
+      fmt::format_to(std::back_inserter(out), "\nstruct s{} {{\n{}{}}}\n", i, struct_bodies[i],
+                     extras[i]);
+    }
+    writeOverrides(root);
+
+    generated.key_count =
+        options_.structs * options_.depth * options_.keys_per_struct +
+        options_.protos * options_.references_per_proto * options_.keys_per_proto +
+        options_.value_lookups + options_.expressions;
+    return generated;
+  }
+
+ private:
+  void validate() const {
+    const auto refs = options_.protos * options_.references_per_proto;
+    if (options_.structs == 0 && (refs + options_.value_lookups + options_.expressions) > 0) {
+      THROW_EXCEPTION(std::invalid_argument,
+                      "At least one struct is required to hold references, lookups and "
+                      "expressions.");
+    }
+    if (options_.structs == 0 && options_.protos == 0) {
+      THROW_EXCEPTION(std::invalid_argument, "An empty config is not valid.");
+    }
+    if (options_.depth == 0 && options_.structs > 0) {
+      THROW_EXCEPTION(std::invalid_argument, "The struct depth must be at least 1.");
+    }
+    if (options_.include_files > 0 && options_.structs <= options_.include_files) {
+      // Every included file needs at least one struct, otherwise it would be empty (and invalid).
+      THROW_EXCEPTION(std::invalid_argument,
+                      "The number of structs ({}) must be greater than the number of include "
+                      "files ({}).",
+                      options_.structs, options_.include_files);
+    }
+  }
+
+  /// \brief Portable replacement for `std::uniform_int_distribution`, whose output is
+  ///        implementation-defined. This keeps the output identical across standard libraries.
+  auto uniform(std::size_t n) -> std::size_t { return static_cast<std::size_t>(rng_() % n); }
+
+  auto number() -> std::string {
+    const auto value = static_cast<std::int64_t>(uniform(2001)) - 1000;
+    if (uniform(2) == 0) {
+      return fmt::format("{}", value);
+    }
+    return fmt::format("{:.3f}", static_cast<double>(value) / 8.0);
+  }
+
+  /// \brief Writes a random value. Returns true if the value is a plain number (i.e. usable within
+  ///        an expression or as the target of an override).
+  auto writeValue(std::string& out) -> bool {
+    auto it = std::back_inserter(out);
+    switch (uniform(6)) {
+      case 0:
+      case 1:
+        fmt::format_to(it, "{}", number());
+        return true;
+      case 2:
+        fmt::format_to(it, "\"str_{}\"", uniform(100000));
+        return false;
+      case 3:
+        fmt::format_to(it, "{}", uniform(2) == 0);
+        return false;
+      case 4:
+        fmt::format_to(it, "0x{:X}", uniform(0x10000));
+        return false;
+      default:
+        fmt::format_to(it, "[{}, {}, {}]", number(), number(), number());
+        return false;
+    }
+  }
+
+  void writeStructBody(std::string& out, const std::string& path, std::size_t level) {
+    const std::string indent(2 * level, ' ');
+    for (std::size_t k = 0; k < options_.keys_per_struct; ++k) {
+      fmt::format_to(std::back_inserter(out), "{}k{} = ", indent, k);
+      if (writeValue(out)) {
+        numeric_keys_.push_back(fmt::format("{}.k{}", path, k));
+      }
+      out += '\n';
+    }
+    if (level < options_.depth) {
+      fmt::format_to(std::back_inserter(out), "{}struct n{} {{\n", indent, level);
+      writeStructBody(out, fmt::format("{}.n{}", path, level), level + 1);
+      fmt::format_to(std::back_inserter(out), "{}}}\n", indent);
+    }
+  }
+
+  void writeProtos(std::string& out) {
+    if (options_.protos == 0) {
+      return;
+    }
+    auto it = std::back_inserter(out);
+    fmt::format_to(it, "\nstruct protos {{\n");
+    for (std::size_t p = 0; p < options_.protos; ++p) {
+      fmt::format_to(it, "  proto p{} {{\n", p);
+      for (std::size_t k = 0; k < options_.keys_per_proto; ++k) {
+        fmt::format_to(it, "    k{} = ", k);
+        switch (k % 4) {
+          case 0:
+            fmt::format_to(it, "$SCALE");
+            break;
+          case 1:
+            fmt::format_to(it, "\"${{NAME}}.k{}\"", k);
+            break;
+          case 2:
+            fmt::format_to(it, "{{{{ $SCALE * {} }}}}", k);
+            break;
+          default:
+            writeValue(out);
+            break;
+        }
+        out += '\n';
+      }
+      fmt::format_to(it, "  }}\n");
+    }
+    fmt::format_to(it, "}}\n");
+  }
+
+  void writeReferences(std::vector<std::string>& extras) {
+    for (std::size_t p = 0; p < options_.protos; ++p) {
+      for (std::size_t r = 0; r < options_.references_per_proto; ++r) {
+        const auto idx = (p * options_.references_per_proto + r) % options_.structs;
+        fmt::format_to(std::back_inserter(extras[idx]),
+                       "  reference protos.p{} as r{}_{} {{\n"
+                       "    $NAME = $PARENT_NAME\n"
+                       "    $SCALE = {}\n"
+                       "  }}\n",
+                       p, p, r, number());
+      }
+    }
+  }
+
+  void writeLookups(std::vector<std::string>& extras) {
+    for (std::size_t i = 0; i < options_.value_lookups; ++i) {
+      const auto idx = uniform(options_.structs);
+      fmt::format_to(std::back_inserter(extras[idx]), "  lookup{} = $({})\n", i,
+                     randomNumericKey());
+    }
+  }
+
+  void writeExpressions(std::vector<std::string>& extras) {
+    for (std::size_t i = 0; i < options_.expressions; ++i) {
+      const auto idx = uniform(options_.structs);
+      fmt::format_to(std::back_inserter(extras[idx]),
+                     "  expr{} = {{{{ $({}) * {} + $({}) / 2 }}}}\n", i, randomNumericKey(),
+                     uniform(9) + 1, randomNumericKey());
+    }
+  }
+
+  void writeOverrides(std::string& out) {
+    // Pick a random subset of the numeric keys (partial Fisher-Yates shuffle).
+    std::vector<std::size_t> indices(numeric_keys_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    for (std::size_t i = 0; i < options_.overrides; ++i) {
+      std::swap(indices[i], indices[i + uniform(indices.size() - i)]);
+
+      // Each override is written as a separate (partial) definition of the top level struct.
+      const auto& key = numeric_keys_[indices[i]];
+      const auto parts = [&key]() {
+        std::vector<std::string> p;
+        std::size_t start = 0;
+        for (auto pos = key.find('.'); pos != std::string::npos; pos = key.find('.', start)) {
+          p.push_back(key.substr(start, pos - start));
+          start = pos + 1;
+        }
+        p.push_back(key.substr(start));
+        return p;
+      }();
+      auto it = std::back_inserter(out);
+      fmt::format_to(it, "\n");
+      for (std::size_t level = 0; level + 1 < parts.size(); ++level) {
+        fmt::format_to(it, "{}struct {} {{\n", std::string(2 * level, ' '), parts[level]);
+      }
+      fmt::format_to(it, "{}{} [override] = {}\n", std::string(2 * (parts.size() - 1), ' '),
+                     parts.back(), number());
+      for (std::size_t level = parts.size() - 1; level > 0; --level) {
+        fmt::format_to(it, "{}}}\n", std::string(2 * (level - 1), ' '));
+      }
+    }
+  }
+
+  auto randomNumericKey() -> const std::string& {
+    return numeric_keys_[uniform(numeric_keys_.size())];
+  }
+
+  const Options& options_;
+  std::mt19937_64 rng_;
+  std::vector<std::string> numeric_keys_;
+};
+
+}  // namespace
+
+namespace flexi_cfg::generator {
+
+auto GeneratedConfig::write(const std::filesystem::path& dir) const -> std::filesystem::path {
+  std::filesystem::create_directories(dir);
+  for (const auto& [filename, contents] : files) {
+    std::ofstream out(dir / filename);
+    if (!out) {
+      THROW_EXCEPTION(std::runtime_error, "Unable to open '{}' for writing.",
+                      (dir / filename).string());
+    }
+    out << contents;
+  }
+  return dir / files.front().first;
+}
+
+auto generate(const Options& options) -> GeneratedConfig { return Generator(options).run(); }
+
+auto optionsForKeyCount(std::size_t n_keys, std::uint64_t seed) -> Options {
+  Options options;
+  options.seed = seed;
+  options.depth = 3;
+  options.keys_per_struct = 10;
+  options.protos = 4;
+  options.keys_per_proto = 8;
+  // Roughly 15% of the keys come from references, 5% from lookups and 5% from expressions. The
+  // remainder are plain key/value pairs in the structs.
+  options.references_per_proto = std::max<std::size_t>(1, n_keys / 200);
+  options.value_lookups = n_keys / 20;
+  options.expressions = n_keys / 20;
+  options.overrides = n_keys / 100;
+  const auto ref_keys = options.protos * options.references_per_proto * options.keys_per_proto;
+  const auto other_keys = ref_keys + options.value_lookups + options.expressions;
+  const auto struct_keys = n_keys > other_keys ? n_keys - other_keys : 0;
+  options.structs =
+      std::max<std::size_t>(1, struct_keys / (options.depth * options.keys_per_struct));
+  options.include_files = std::min<std::size_t>(8, options.structs - 1);
+  return options;
+}
+
+}  // namespace flexi_cfg::generator
@@ -1,16 +1,18 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <map>
 #include <memory>
-#include <range/v3/algorithm/find.hpp>
-#include <range/v3/range/conversion.hpp>
-#include <range/v3/view/drop_last.hpp>
-#include <range/v3/view/map.hpp>
-#include <range/v3/view/set_algorithm.hpp>
-#include <regex>
+#include <optional>
 #include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/classes.h"
@@ -18,7 +20,8 @@
 #include "flexi_cfg/config/helpers.h"
 #include "flexi_cfg/config/parser-internal.h"
 #include "flexi_cfg/logger.h"
-#include "flexi_cfg/math/actions.h"
+#include "flexi_cfg/math/program.h"
+#include "flexi_cfg/stats.h"
 #include "flexi_cfg/utils.h"
 
 namespace {
@@ -61,45 +64,77 @@ auto checkForErrors(const types::CfgMap& cfg1, const types::CfgMap& cfg2, const
   return dict_count == 2;  // All good if both are dictionaries (for now);
 }
 
+namespace {
+/// \brief Merges the contents of `src` into `dst` in place. Keys that only exist in `src` are
+///        appended to `dst`, struct-likes that exist in both are merged recursively & any other
+///        duplicates are reported by `checkForErrors`. When `src` is an rvalue, its contents
+///        (including the contents of any nested structs) are moved rather than copied.
+template <typename Map>
+void mergeInto(types::CfgMap& dst, Map&& src) {
+  constexpr bool kMove = std::is_rvalue_reference_v<Map&&> &&
+                         !std::is_const_v<std::remove_reference_t<Map>>;
+  for (auto& [key, value] : src) {
+    if (!dst.contains(key)) {
+      if constexpr (kMove) {
+        dst.try_emplace(key, std::move(value));
+      } else {
+        dst.try_emplace(key, value);
+      }
+      continue;
+    }
+    // Throws unless both are struct-likes of the same type.
+    checkForErrors(dst, src, key);
+    auto& dst_data = dynamic_pointer_cast<types::ConfigStructLike>(dst.at(key))->data;
+    auto& src_data = dynamic_pointer_cast<types::ConfigStructLike>(value)->data;
+    if constexpr (kMove) {
+      mergeInto(dst_data, std::move(src_data));
+    } else {
+      mergeInto(dst_data, std::as_const(src_data));
+    }
+  }
+}
+
+/// \brief Whether `node` is a list of nodes. Packed lists only hold number & boolean literals, so
+///        there is never anything to resolve within them.
+auto isNodeList(const types::BasePtr& node) -> bool {
+  return node->type == types::Type::kList &&
+         dynamic_cast<const types::ConfigList&>(*node).packed() == nullptr;
+}
+}  // namespace
+
 /* Merge dictionaries recursively and keep all nested keys combined between the two dictionaries.
  * Any key/value pairs that already exist in the leaves of cfg1 will be overwritten by the same
  * key/value pairs from cfg2. */
 auto mergeNestedMaps(const types::CfgMap& cfg1, const types::CfgMap& cfg2) -> types::CfgMap {
-  // Get sorted keys from both configs
-  auto keys1 = cfg1 | ranges::views::keys | ranges::to<std::vector<std::string>>;
-  auto keys2 = cfg2 | ranges::views::keys | ranges::to<std::vector<std::string>>;
-  std::sort(keys1.begin(), keys1.end());
-  std::sort(keys2.begin(), keys2.end());
-
-  const auto common_keys = ranges::views::set_intersection(keys1, keys2);
-
-  for (const auto& k : common_keys) {
-    checkForErrors(cfg1, cfg2, k);
-  }
-
-  // This over-writes the top level keys in dict1 with dict2. If there are
-  // nested dictionaries, we need to handle these appropriately.
-  types::CfgMap cfg_out{};
-  std::copy(std::begin(cfg1), std::end(cfg1), std::inserter(cfg_out, cfg_out.end()));
-  std::copy(std::begin(cfg2), std::end(cfg2), std::inserter(cfg_out, cfg_out.end()));
-  for (const auto& el : cfg_out) {
-    const auto& key = el.first;
-    if (ranges::find(std::begin(common_keys), std::end(common_keys), key) !=
-        std::end(common_keys)) {
-      // Find any values in the top-level keys that are also dictionaries.
-      // Call this function recursively.
-      if (isStructLike(cfg1.at(key)) && isStructLike(cfg2.at(key))) {
-        // This means that both the element found in `cfg_out[key]` and those in `cfg1[key]` and
-        // `cfg2[key]` are all struct-like elements. We need to convert them all so we can operate
-        // on them.
-        dynamic_pointer_cast<types::ConfigStructLike>(cfg_out[key])->data =
-            mergeNestedMaps(dynamic_pointer_cast<types::ConfigStructLike>(cfg1.at(key))->data,
-                            dynamic_pointer_cast<types::ConfigStructLike>(cfg2.at(key))->data);
-      }
-    }
+  types::CfgMap cfg_out = cfg1;
+  mergeInto(cfg_out, cfg2);
+  return cfg_out;
+}
+
+auto mergeNested(std::vector<types::CfgMap>&& in) -> types::CfgMap {
+  if (in.empty()) {
+    // TODO(miker2): Throw exception here? How to handle empty vector?
+    return {};
   }
 
-  return cfg_out;
+  // Merge everything into the first element. Each of the remaining elements is merged in a single
+  // pass over its keys. Membership checks are hash lookups and the values are moved, not copied.
+  types::CfgMap squashed_cfg = std::move(in.front());
+  for (auto& cfg : std::span(in).subspan(1)) {
+    logger::trace(
+        "======= Working on merging: =======\n{}\n"
+        "++++++++++++++ and ++++++++++++++++\n{}",
+        fmt::join(squashed_cfg, "\n"), fmt::join(cfg, "\n"));
+
+    mergeInto(squashed_cfg, std::move(cfg));
+
+    logger::trace(
+        "++++++++++++ result +++++++++++++++\n{}\n"
+        "============== END ================\n",
+        fmt::join(squashed_cfg, "\n"));
+  }
+  in.clear();
+  return squashed_cfg;
 }
 
 auto structFromReference(std::shared_ptr<types::ConfigReference>& ref,
@@ -123,6 +158,7 @@ auto structFromReference(std::shared_ptr<types::ConfigReference>& ref,
     }
     // types::BasePtr value = el.second->clone();
     struct_out->data[el.first] = el.second->clone();
+    stats::count(&ParseStats::clones);
   }
 
   // Next, move the data from the reference to the struct:
@@ -140,6 +176,212 @@ auto structFromReference(std::shared_ptr<types::ConfigReference>& ref,
   return struct_out;
 }
 
+namespace {
+/// \brief Checks if `c` may be part of the name of a var (see `grammar::VARc`)
+auto isVarChar(char c) -> bool {
+  return std::isupper(static_cast<unsigned char>(c)) != 0 ||
+         std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+/// \brief The text that replaces a var, or `std::nullopt` if `name` isn't a var that holds a value
+auto varReplacement(const types::RefMap& ref_vars, std::string_view name)
+    -> std::optional<std::string_view> {
+  const auto var = ref_vars.find(name);
+  if (var == ref_vars.end()) {
+    return std::nullopt;
+  }
+  // Only a value can be substituted (i.e. not a kValueLookup or kVar).
+  const auto* value = dynamic_cast<const types::ConfigValue*>(var->second.get());
+  if (value == nullptr) {
+    logger::trace(" -- rK: {} is of type {} and does not contain a string. Skipping...", name,
+                  var->second->type);
+    return std::nullopt;
+  }
+  // Strip off any leading or trailing quotes from the replacement value. If the replacement
+  // value is not a string, this is a no-op.
+  std::string_view replacement = value->value;
+  const auto first = replacement.find_first_not_of("\\\"");
+  if (first == std::string_view::npos) {
+    return std::string_view{};
+  }
+  replacement = replacement.substr(first, replacement.find_last_not_of("\\\"") + 1 - first);
+  return replacement;
+}
+
+/// \brief Appends the text of a numeric var to an expression
+/// \return False if the var isn't a number (see `fillExpressionVars`)
+auto appendNumberVar(std::string& out, const types::RefMap& ref_vars, std::string_view name)
+    -> bool {
+  const auto var = ref_vars.find(name);
+  if (var == ref_vars.end() || var->second->type != types::Type::kNumber) {
+    return false;
+  }
+  const auto* value = dynamic_cast<const types::ConfigValue*>(var->second.get());
+  if (value == nullptr) {
+    return false;
+  }
+  if (value->value.find_first_of("xX") == std::string::npos) {
+    out += value->value;
+    return true;
+  }
+  // A hex number isn't valid within an expression, so use its (decimal) value instead.
+  if (const auto* i_val = std::get_if<int64_t>(&value->number)) {
+    out += std::to_string(*i_val);
+    return true;
+  }
+  if (const auto* ui_val = std::get_if<uint64_t>(&value->number)) {
+    out += std::to_string(*ui_val);
+    return true;
+  }
+  return false;
+}
+
+/// \brief Appends the text of a var within a value lookup to the key of the value lookup
+/// \return False if the value of the var isn't a (flat) key (see `fillExpressionVars`)
+auto appendKeyVar(std::string& key, const types::RefMap& ref_vars, std::string_view name)
+    -> bool {
+  const auto replacement = varReplacement(ref_vars, name);
+  if (!replacement.has_value()) {
+    return false;
+  }
+  // Only the text of the var is checked, as the rest of the key was checked by the original parse.
+  peg::memory_input input(replacement->data(), replacement->size(), "");
+  if (!peg::parse<peg::seq<FLAT_KEY, peg::eof>>(input)) {
+    return false;
+  }
+  key += *replacement;
+  return true;
+}
+
+/// \brief Fills in the vars of an expression directly from its tokens, without re-parsing it.
+///        This produces the same expression as `replaceVarInStr` (followed by parsing the result).
+///        Returns `nullptr` if the expression must be re-parsed instead. This is only the case for
+///        expressions that are either invalid or unusual:
+///          - a var that isn't defined, or doesn't hold a value (e.g. it holds a value lookup),
+///            which is an error
+///          - a var whose value isn't a number (e.g. a string), as its text has to be parsed as
+///            part of the expression
+///          - a var within a value lookup whose value isn't a key
+auto fillExpressionVars(const types::ConfigExpression& expression, const types::RefMap& ref_vars)
+    -> std::shared_ptr<types::ConfigExpression> {
+  using Kind = types::ConfigExpression::Token::Kind;
+  std::string out;
+  out.reserve(expression.value.size());
+  // The keys of the value lookups that contain vars
+  std::vector<std::string> keys;
+  std::size_t n_replaced = 0;
+  for (const auto& token : expression.tokens) {
+    if (token.kind == Kind::kLiteral) {
+      out += token.text;
+    } else if (token.kind == Kind::kValueLookup) {
+      if (token.parts.empty()) {
+        out.append("$(").append(token.text).append(")");
+        continue;
+      }
+      auto& key = keys.emplace_back();
+      for (const auto& part : token.parts) {
+        if (part.kind == Kind::kLiteral) {
+          key += part.text;
+          continue;
+        }
+        if (part.kind != Kind::kVar || !appendKeyVar(key, ref_vars, part.text)) {
+          return nullptr;
+        }
+        ++n_replaced;
+      }
+      out.append("$(").append(key).append(")");
+    } else if (appendNumberVar(out, ref_vars, token.text)) {
+      ++n_replaced;
+    } else {
+      return nullptr;
+    }
+  }
+  stats::count(&ParseStats::var_substitutions, n_replaced);
+  if (keys.empty()) {
+    // The value lookups are unchanged, so they can be shared with the original expression.
+    return std::make_shared<types::ConfigExpression>(std::move(out), expression.value_lookups);
+  }
+
+  // Rebuild the value lookups (in the order in which they appear), replacing those with vars.
+  types::CfgMap value_lookups;
+  auto next_key = keys.begin();
+  for (const auto& token : expression.tokens) {
+    if (token.kind != Kind::kValueLookup) {
+      continue;
+    }
+    const auto original = expression.value_lookups.find(token.text);
+    if (token.parts.empty()) {
+      if (original != expression.value_lookups.end()) {
+        value_lookups.try_emplace(token.text, original->second);
+      }
+      continue;
+    }
+    auto lookup = std::make_shared<types::ConfigValueLookup>(*next_key);
+    if (original != expression.value_lookups.end()) {
+      lookup->line = original->second->line;
+      lookup->source = original->second->source;
+    }
+    value_lookups.try_emplace(std::move(*next_key++), std::move(lookup));
+  }
+  return std::make_shared<types::ConfigExpression>(std::move(out), std::move(value_lookups));
+}
+
+/// \brief Appends `input` to `out`, replacing each `$VAR` & `${VAR}` with the value of the var.
+///        The substituted text is scanned again (up to `depth` times), so the value of a var may
+///        itself refer to other vars.
+void appendReplacingVars(std::string_view input, const types::RefMap& ref_vars, std::size_t depth,
+                         std::string& out, std::string& name) {
+  std::size_t pos = 0;
+  while (pos < input.size()) {
+    const auto dollar = input.find('$', pos);
+    out.append(input.substr(pos, dollar - pos));
+    if (dollar == std::string_view::npos) {
+      return;
+    }
+    pos = dollar + 1;
+
+    // Find the name of the var (along with the '$'), and where the var ends.
+    name.assign("$");
+    std::size_t end = pos;
+    std::optional<std::string_view> replacement;
+    if (pos < input.size() && input[pos] == '{') {
+      const auto close = input.find('}', pos);
+      if (close != std::string_view::npos) {
+        name.append(input.substr(pos + 1, close - pos - 1));
+        replacement = varReplacement(ref_vars, name);
+        end = close + 1;
+      }
+    } else if (pos < input.size() && std::isupper(static_cast<unsigned char>(input[pos])) != 0) {
+      // An un-braced var may be followed directly by more text, so use the longest var whose name
+      // starts the text (e.g. `$NAME_x` refers to `$NAME` unless `$NAME_X` exists).
+      const auto run = std::find_if_not(input.begin() + pos, input.end(), isVarChar);
+      name.append(input.substr(pos, static_cast<std::size_t>(run - input.begin()) - pos));
+      for (; name.size() > 1; name.pop_back()) {
+        if (replacement = varReplacement(ref_vars, name); replacement.has_value()) {
+          end = pos + name.size() - 1;
+          break;
+        }
+      }
+    }
+
+    if (!replacement.has_value()) {
+      // Not a var that can be replaced (e.g. a value lookup or an unknown var), so keep the '$'.
+      out.push_back('$');
+      continue;
+    }
+    logger::debug("Replacing {} with '{}'", input.substr(dollar, end - dollar), *replacement);
+    stats::count(&ParseStats::var_substitutions);
+    if (depth > 0 && replacement->find('$') != std::string_view::npos) {
+      // NOTE: `name` is reused by the nested call, and `replacement` refers to a var (not `name`).
+      appendReplacingVars(*replacement, ref_vars, depth - 1, out, name);
+    } else {
+      out.append(*replacement);
+    }
+    pos = end;
+  }
+}
+}  // namespace
+
 auto replaceVarInStr(std::string input, const types::RefMap& ref_vars)
     -> std::optional<std::string> {
   // Before doing any of this, maybe check if there is a "$" in v_value->value, otherwise, no
@@ -151,31 +393,15 @@ auto replaceVarInStr(std::string input, const types::RefMap& ref_vars)
     return std::nullopt;
   }
 
-  auto out = std::move(input);
-  // Find instances of 'ref_vars' in 'input' and replace.
-  for (const auto& rkv : ref_vars) {
-    const auto& rk = rkv.first;
-    auto rv = dynamic_pointer_cast<types::ConfigValue>(rkv.second);
-    // Only continue if the k/v pair contains a value (i.e. not a kValueLookup or kVar)
-    if (rv == nullptr) {
-      logger::trace(" -- rK: {} is of type {} and does not contain a string. Skipping...", rk,
-                    rkv.second->type);
-      continue;
-    }
-    logger::debug("v: {}, rk: {}, rv: {}", out, rk, rkv.second);
-
-    // Strip off any leading or trailing quotes from the replacement value. If the replacement
-    // value is not a string, this is a no-op.
-    const auto replacement = utils::trim(rv->value, "\\\"");
-    // Look for `rk` (escape leading '$') in `out` and replace them with 'replacement'
-    out = std::regex_replace(out, std::regex(std::string("\\").append(rk)), replacement);
-    // Turn the $VAR version into ${VAR} in case that is used within a string as well. Throw
-    // in escape characters as this will be used in a regular expression.
-    const auto bracket_var = std::regex_replace(rk, std::regex("\\$(.+)"), R"(\$\{$1\})");
-    logger::debug("v: {}, rk: {}, rv: {}", out, bracket_var, rkv.second);
-    out = std::regex_replace(out, std::regex(bracket_var), replacement);
-    logger::debug("out: {}", out);
-  }
+  std::string out;
+  out.reserve(input.size());
+  out.append(input, 0, var_pos);
+  std::string name;
+  // A chain of vars (each of which refers to the next) can be no longer than the number of vars,
+  // so this also stops a var that refers to itself.
+  appendReplacingVars(std::string_view(input).substr(var_pos), ref_vars, ref_vars.size(), out,
+                      name);
+  logger::debug("out: {}", out);
   return out;
 }
 
@@ -193,17 +419,8 @@ void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars) {
       "  -- END --",
       cfg_map, ref_vars);
 
-  auto str_contains_var = [](const std::string& str) {
-    // Use the existing VAR grammar rule to check if any variables exist
-    peg::memory_input in(str, "contains VAR?");
-    config::ActionData state;
-    // NOTE: 'peg::until' will consume everything until the rule 'config::VAR' matches. If
-    // 'config::VAR' never matches, then 'parse' will return false, otherwise true
-    const auto ret = internal::parseCore<peg::until<config::VAR>, config::action>(in, state);
-    return ret;
-  };
 
-  for (const auto& kv : cfg_map) {
+  for (auto& kv : cfg_map) {
     const auto& k = kv.first;
     const auto& v = kv.second;
     if (CONFIG_HELPERS_DEBUG) {
@@ -242,13 +459,13 @@ void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars) {
     };
 
     if (v->type == types::Type::kVar) {
-      cfg_map[k] = replace_var(v);
+      kv.second = replace_var(v);
     } else if (v->type == types::Type::kString) {
-      cfg_map[k] = replace_var_in_str(v);
-    } else if (v->type == types::Type::kList) {
+      kv.second = replace_var_in_str(v);
+    } else if (isNodeList(v)) {
       auto v_list = dynamic_pointer_cast<types::ConfigList>(v);
       logger::trace("Resolving references in list: {}", v_list);
-      for (auto& e : v_list->data) {
+      for (auto& e : v_list->nodes()) {
         logger::trace("Element type: {}, data: {}", e->type, e);
         if (e->type == types::Type::kVar) {
           e = replace_var(e);
@@ -266,30 +483,47 @@ void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars) {
       logger::trace("Resolved list: {}", v_list);
     } else if (v->type == types::Type::kExpression) {
       auto expression = dynamic_pointer_cast<types::ConfigExpression>(v);
+      if (!expression->hasVars()) {
+        continue;
+      }
+      // The vars can almost always be filled in directly from the tokens of the expression.
+      if (auto filled = fillExpressionVars(*expression, ref_vars); filled != nullptr) {
+        filled->line = v->line;
+        filled->source = v->source;
+        kv.second = std::move(filled);
+        continue;
+      }
 
       auto out = replaceVarInStr(expression->value, ref_vars);
       if (!out.has_value()) {
         continue;
       }
-      // If anything has been replaced, we need to recreate the entire expression using the grammar
-      // (in order to identify any ValueLookup objects in the expression now that the Var objects
-      // have been resolved.
+      // Otherwise, the entire expression has to be recreated using the grammar (in order to
+      // identify any ValueLookup objects in the expression now that the Var objects have been
+      // resolved).
       config::ActionData state;
       peg::memory_input input(out.value(), k);
-      internal::parseCore<EXPRESSION, config::action>(input, state);
+      const auto parsed = internal::parseCore<EXPRESSION, config::action>(input, state);
+      const auto new_expression = dynamic_pointer_cast<types::ConfigExpression>(state.obj_res);
+      if (!parsed || new_expression == nullptr) {
+        THROW_EXCEPTION(InvalidConfigException,
+                        "Key: '{}' (at {}) is not a valid expression once its VARs are replaced: "
+                        "'{}'",
+                        k, v->loc(), out.value());
+      }
 
-      state.obj_res->line = v->line;
-      state.obj_res->source = v->source;
-      auto contains_var = str_contains_var(out.value());
+      new_expression->line = v->line;
+      new_expression->source = v->source;
+      const auto contains_var = new_expression->hasVars();
       logger::debug("{} has var? {}", out.value(), contains_var);
       if (contains_var) {
         THROW_EXCEPTION(
             InvalidConfigException,
             "Key: '{}' of type '{}' (at {}) contains unresolved VARs: '{}'. Did reference '{}' "
             "fail to define all variables?",
-            k, v->type, v->loc(), out.value(), ref_vars.at("$PARENT"));
+            k, v->type, v->loc(), out.value(), ref_vars.at("$PARENT_NAME"));
       }
-      cfg_map[k] = std::move(state.obj_res);
+      kv.second = new_expression;
     } else if (v->type == types::Type::kValueLookup) {
       logger::debug("Key: {}, checking {} for vars.", k, v);
       auto v_val_lookup = dynamic_pointer_cast<types::ConfigValueLookup>(v);
@@ -302,7 +536,7 @@ void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars) {
       auto new_val_lookup = std::make_shared<types::ConfigValueLookup>(out.value());
       new_val_lookup->line = v->line;
       new_val_lookup->source = v->source;
-      cfg_map[k] = std::move(new_val_lookup);
+      kv.second = std::move(new_val_lookup);
     } else if (isStructLike(v)) {
       logger::debug("At '{}', found {}", k, v->type);
       // Recurse deeper into the structure in order to replace more variables.
@@ -317,67 +551,112 @@ void replaceProtoVar(types::CfgMap& cfg_map, const types::RefMap& ref_vars) {
       cfg_map);
 }
 
-auto getNestedConfig(const types::CfgMap& cfg, const std::vector<std::string>& keys)
-    -> std::shared_ptr<types::ConfigStructLike> {
-  // Keep track of the re-joined keys (from the front to the back) as we recurse into the map in
-  // order to make error messages more useful.
-  std::string rejoined{};
+namespace {
+/// \brief The keys preceding `it`, joined. This is only used for error messages.
+auto keysBefore(const std::vector<std::string>& keys, std::vector<std::string>::const_iterator it)
+    -> std::string {
+  return utils::join({keys.begin(), it}, ".");
+}
+
+auto keysBefore(const utils::SplitView& keys, const utils::SplitView::iterator& it)
+    -> std::string_view {
+  return keys.prefix(it);
+}
+
+/// \brief Walks through all but the last of `keys`, starting at `cfg`. Nothing is allocated unless
+///        one of the keys can't be found.
+/// \return The (owning pointer of the) struct-like object containing the last key, or `nullptr` if
+///         there is only one key, along with an iterator to the last key.
+template <typename Keys>
+auto walkKeys(const types::CfgMap& cfg, const Keys& keys)
+    -> std::pair<const types::BasePtr*, decltype(std::begin(keys))> {
+  const types::BasePtr* parent = nullptr;
   // Start with the base config tree and work our way down through the keys.
   const auto* content = &cfg;
-  // Walk through each part of the flat key (except the last one, as it will be the one that
-  // contains the data.
-  std::shared_ptr<types::ConfigStructLike> struct_like;
-  for (const auto& key : keys | ranges::views::drop_last(1)) {
-    if (!content->contains(key)) {
-      THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", key, rejoined);
+  auto it = std::begin(keys);
+  if (it == std::end(keys)) {
+    return {parent, it};
+  }
+  for (auto next = std::next(it); next != std::end(keys); it = next++) {
+    const std::string_view key = *it;
+    const auto found = content->find(key);
+    if (found == content->end()) {
+      THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", key,
+                      keysBefore(keys, it));
     }
 
-    rejoined = utils::makeName(rejoined, key);
-
-    struct_like = dynamic_pointer_cast<types::ConfigStructLike>(content->at(key));
-    // If the dynamic_pointer_cast fails, then we can't continue with the loop and whatever is
-    // returned by 'content->at(key)' doesn't have any content of it's own.
+    const auto* struct_like = dynamic_cast<const types::ConfigStructLike*>(found->second.get());
+    // If the cast fails, then we can't continue with the loop, as whatever is found doesn't have
+    // any content of it's own.
     if (struct_like == nullptr) {
       THROW_EXCEPTION(InvalidTypeException,
                       "Expected value at '{}' to be a struct-like object, but got {} type instead.",
-                      rejoined, content->at(key)->type);
+                      keysBefore(keys, next), found->second->type);
     }
     // Pull out the contents of the struct-like and move on to the next iteration.
+    parent = &found->second;
     content = &(struct_like->data);
   }
-
-  return struct_like;
+  return {parent, it};
 }
 
-auto getNestedConfig(const types::CfgMap& cfg, const std::string& flat_key)
+template <typename Keys>
+auto nestedConfig(const types::CfgMap& cfg, const Keys& keys)
     -> std::shared_ptr<types::ConfigStructLike> {
-  const auto keys = utils::split(flat_key, '.');
-  return getNestedConfig(cfg, keys);
+  const auto [parent, last] = walkKeys(cfg, keys);
+  return parent != nullptr ? std::static_pointer_cast<types::ConfigStructLike>(*parent) : nullptr;
 }
 
-auto getConfigValue(const types::CfgMap& cfg, const std::vector<std::string>& keys)
-    -> types::BasePtr {
-  // Get the struct-like object containing the last key of the ConfigValueLookup:
-  const auto struct_like = getNestedConfig(cfg, keys);
+template <typename Keys>
+auto configValue(const types::CfgMap& cfg, const Keys& keys) -> types::BasePtr {
+  // Get the struct-like object containing the last key:
+  const auto [parent, last] = walkKeys(cfg, keys);
+  if (last == std::end(keys)) {
+    THROW_EXCEPTION(InvalidKeyException, "Unable to look up an empty key!");
+  }
 
   // Special handling for the case where 'keys' only has one entry:
-  // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
-  const auto& cfg_tail = (struct_like != nullptr) ? struct_like->data : cfg;
+  const auto& cfg_tail =
+      (parent != nullptr) ? static_cast<const types::ConfigStructLike&>(**parent).data : cfg;
 
-  if (!cfg_tail.contains(keys.back())) {
-    auto keys_minus_tail = keys;
-    keys_minus_tail.pop_back();
-    THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", keys.back(),
-                    utils::join(keys_minus_tail, "."));
+  // Extract the value from the final CfgMap object using the final key.
+  const std::string_view key = *last;
+  const auto found = cfg_tail.find(key);
+  if (found == cfg_tail.end()) {
+    THROW_EXCEPTION(InvalidKeyException, "Unable to find '{}' in '{}'!", key,
+                    keysBefore(keys, last));
   }
+  return found->second;
+}
+}  // namespace
 
-  // Extract the value from the final CfgMap object using the final key.
-  return cfg_tail.at(keys.back());
+auto getNestedConfig(const types::CfgMap& cfg, const std::vector<std::string>& keys)
+    -> std::shared_ptr<types::ConfigStructLike> {
+  return nestedConfig(cfg, keys);
+}
+
+auto getNestedConfig(const types::CfgMap& cfg, const utils::SplitView& keys)
+    -> std::shared_ptr<types::ConfigStructLike> {
+  return nestedConfig(cfg, keys);
+}
+
+auto getNestedConfig(const types::CfgMap& cfg, std::string_view flat_key)
+    -> std::shared_ptr<types::ConfigStructLike> {
+  return nestedConfig(cfg, utils::splitView(flat_key));
+}
+
+auto getConfigValue(const types::CfgMap& cfg, const std::vector<std::string>& keys)
+    -> types::BasePtr {
+  return configValue(cfg, keys);
+}
+
+auto getConfigValue(const types::CfgMap& cfg, const utils::SplitView& keys) -> types::BasePtr {
+  return configValue(cfg, keys);
 }
 
 auto getConfigValue(const types::CfgMap& cfg, const std::shared_ptr<types::ConfigValueLookup>& var)
     -> types::BasePtr {
-  return getConfigValue(cfg, var->keys);
+  return getConfigValue(cfg, var->keys());
 }
 
 /// \brief Handles the resolution of kValueLookup objects
@@ -444,19 +723,19 @@ void resolveVarRefs(const types::CfgMap& root, types::CfgMap& sub_tree,
     }
   };
 
-  for (const auto& kv : sub_tree) {
+  for (auto& kv : sub_tree) {
     const auto src_key = utils::makeName(parent_key, kv.first);
     if (kv.second && kv.second->type == types::Type::kValueLookup) {
       // Add the source key to the reference list (if we ever get back to this key, it's a failure).
       logger::trace("For {}, found {} (type={}).", src_key, kv.second, kv.second->type);
-      sub_tree[kv.first] = resolveVarRefs(root, src_key, kv.second);
+      kv.second = resolveVarRefs(root, src_key, kv.second);
     } else if (kv.second && kv.second->type == types::Type::kExpression) {
       auto expression = dynamic_pointer_cast<types::ConfigExpression>(kv.second);
       resolve_expression_vars(expression, src_key);
-    } else if (kv.second && kv.second->type == types::Type::kList) {
+    } else if (kv.second && isNodeList(kv.second)) {
       // Check the elements of the list to see if it contains any kValueLookup objects
       auto list = dynamic_pointer_cast<types::ConfigList>(kv.second);
-      for (auto& el : list->data) {
+      for (auto& el : list->nodes()) {
         if (el->type == types::Type::kValueLookup) {
           logger::trace("Found {} in {}.{} which is a {}", el->type, parent_key, kv.first,
                         kv.second->type);
@@ -485,8 +764,6 @@ void resolveVarRefs(const types::CfgMap& root, types::CfgMap& sub_tree,
 
 auto evaluateExpression(std::shared_ptr<types::ConfigExpression>& expression,
                         const std::string& key) -> std::shared_ptr<types::ConfigValue> {
-  math::ActionData math;
-  // Fill in math.var_ref_map;
   for (const auto& var_ref : expression->value_lookups) {
     if (var_ref.second->type != types::Type::kNumber) {
       logger::critical("{} is not a number (type={})!", var_ref.first, var_ref.second->type);
@@ -497,27 +774,47 @@ auto evaluateExpression(std::shared_ptr<types::ConfigExpression>& expression,
           key, expression, expression->loc(), var_ref.first, var_ref.second->type,
           types::Type::kNumber);
     }
-    math.var_ref_map[var_ref.first] =
-        std::stod(dynamic_pointer_cast<types::ConfigValue>(var_ref.second)->value);
   }
-  peg::memory_input input(expression->value, key);
-  internal::parseCore<peg::seq<config::Eo, math::expression, config::Ec>, math::action>(input,
-                                                                                        math);
-  return std::make_shared<types::ConfigValue>(std::to_string(math.res), types::Type::kNumber,
-                                              math.res);
+  if (!expression->program) {
+    expression->program = math::compile(expression->value, key);
+  }
+  const auto& program = *expression->program;
+  // Bind the value of each value lookup to its slot in the program.
+  std::vector<double> values;
+  values.reserve(program.slots.size());
+  for (const auto& slot : program.slots) {
+    const auto it = expression->value_lookups.find(slot);
+    if (it == expression->value_lookups.end()) {
+      THROW_EXCEPTION(std::runtime_error, "This should never happen! {} not found!", slot);
+    }
+    const auto value = dynamic_pointer_cast<types::ConfigValue>(it->second);
+    // Numbers are decoded when they are created, so there is no need to parse the text again.
+    values.push_back(std::visit(
+        [&value](const auto& number) {
+          if constexpr (std::is_same_v<std::decay_t<decltype(number)>, std::monostate>) {
+            return std::stod(value->value);
+          } else {
+            return static_cast<double>(number);
+          }
+        },
+        value->number));
+  }
+  const auto res = program.evaluate(values);
+  stats::count(&ParseStats::expressions_evaluated);
+  return std::make_shared<types::ConfigValue>(std::to_string(res), types::Type::kNumber, res);
 }
 
 void evaluateExpressions(types::CfgMap& cfg, const std::string& parent_key) {
-  for (const auto& kv : cfg) {
+  for (auto& kv : cfg) {
     const auto key = utils::makeName(parent_key, kv.first);
     if (kv.second && kv.second->type == types::Type::kExpression) {
       // Evaluate expression
       logger::debug("Evaluating expression {} = {}", key, kv.second);
       auto expression = dynamic_pointer_cast<types::ConfigExpression>(kv.second);
-      cfg[kv.first] = evaluateExpression(expression);
-    } else if (kv.second && kv.second->type == types::Type::kList) {
+      kv.second = evaluateExpression(expression);
+    } else if (kv.second && isNodeList(kv.second)) {
       auto list = dynamic_pointer_cast<types::ConfigList>(kv.second);
-      for (auto& el : list->data) {
+      for (auto& el : list->nodes()) {
         if (el->type == types::Type::kExpression) {
           logger::debug("Found a list element that contains an expression: {}!", el);
           auto expression = dynamic_pointer_cast<types::ConfigExpression>(el);
@@ -550,9 +847,12 @@ auto unflatten(const std::span<std::string> keys, const types::CfgMap& cfg) -> t
 /// \param[in] flat_key - The dot-separated key
 /// \param[in/out] cfg - The root of the existing data structure
 /// \param[in] depth - The current depth level of the data structure
-void unflatten(const std::string& flat_key, types::CfgMap& cfg, std::size_t depth) {
+void unflatten(std::string_view flat_key, types::CfgMap& cfg, std::size_t depth) {
   // Split off the first element of the flat key
-  const auto [head, tail] = utils::splitHead(flat_key);
+  const auto split_pos = flat_key.find('.');
+  const auto head = flat_key.substr(0, split_pos);
+  const auto tail =
+      split_pos == std::string_view::npos ? std::string_view{} : flat_key.substr(split_pos + 1);
 
   if (tail.empty()) {
     // If there's no tail, then nothing to do.
@@ -563,10 +863,10 @@ void unflatten(const std::string& flat_key, types::CfgMap& cfg, std::size_t dept
   // There are two possible options: the key exists in the current map or it does not. Either way,
   // we need a pointer to the map.
   types::CfgMap* next_cfg = nullptr;
-  if (cfg.contains(head)) {
+  if (const auto found = cfg.find(head); found != cfg.end()) {
     logger::trace("Found key '{}'", head);
     // Get this element, and find the internal data and assign it to our pointer.
-    auto v = cfg[head];
+    const auto& v = found->second;
     if (!isStructLike(v)) {
       THROW_EXCEPTION(InvalidTypeException,
                       "In unflatten, expected {} to be struct-like, but found {} instead.", head,
@@ -576,17 +876,18 @@ void unflatten(const std::string& flat_key, types::CfgMap& cfg, std::size_t dept
   } else {
     // The key doesn't exist in our map. We need to create a new struct and add it to the map.
     logger::debug("Creating key '{}'", head);
-    auto new_struct = std::make_shared<types::ConfigStruct>(head, depth);
-    cfg[head] = new_struct;
+    auto new_struct = std::make_shared<types::ConfigStruct>(std::string(head), depth);
+    cfg.try_emplace(std::string(head), new_struct);
     // Extract the map from our new struct and assign its address to our pointer.
     next_cfg = &(new_struct->data);
   }
 
-  // Move the value to the new cfg (using just the 'tail' as the key).
+  // Move the value to the new cfg (using just the 'tail' as the key), and remove the value from
+  // the existing config.
   logger::trace("Moving value from '{}' to '{}'", flat_key, tail);
-  (*next_cfg)[tail] = std::move(cfg[flat_key]);
-  // And remove the value from the existing config
-  cfg.erase(flat_key);
+  const auto it = cfg.find(flat_key);
+  next_cfg->insert_or_assign(std::string(tail), std::move(it->second));
+  cfg.erase(it);
 
   // Step a layer deeper with any remaining tail.
   unflatten(tail, *next_cfg, depth + 1);
@@ -1,16 +1,25 @@
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <iterator>
+#include <magic_enum.hpp>
+#include <memory>
+#include <optional>
 #include <range/v3/action/remove_if.hpp>
 #include <range/v3/action/reverse.hpp>
 #include <range/v3/action/sort.hpp>
 #include <range/v3/range/conversion.hpp>
-#include <range/v3/view/drop_last.hpp>
 #include <range/v3/view/filter.hpp>
-#include <range/v3/view/tail.hpp>
 #include <set>
 #include <sstream>
 #include <tao/pegtl.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/classes.h"
@@ -20,6 +29,7 @@
 #include "flexi_cfg/logger.h"
 #include "flexi_cfg/parser.h"
 #include "flexi_cfg/reader.h"
+#include "flexi_cfg/stats.h"
 #include "flexi_cfg/utils.h"
 
 namespace {
@@ -63,11 +73,15 @@ auto parseCommon(INPUT& input, flexi_cfg::config::ActionData& output) {
     flexi_cfg::logger::critical("  Parser failure!");
     flexi_cfg::logger::critical("{}\n", e.what());
     for (const auto& p : e.positions()) {
-      if (p.source != input.source()) {
-        peg::file_input input_other{p.source};  // reload the file (maybe keep in ActionData?)
-        flexi_cfg::logger::critical("{}", input_other.line_at(p));
-      } else {  // assume no file means the root input
+      if (p.source == input.source()) {
         flexi_cfg::logger::critical("{}", input.line_at(p));
+      } else {
+        // Included files are already in the file table; nothing new is read just to show the line.
+        if (const auto other = output.files->find(p.source)) {
+          flexi_cfg::logger::critical("{}", other->input().line_at(p));
+        } else {
+          flexi_cfg::logger::critical("<source of '{}' is not available>", p.source);
+        }
       }
       flexi_cfg::logger::critical("{}^", std::string(p.column - 1, ' '));
       flexi_cfg::logger::critical("at {}:{}:{}", p.source, p.line, p.column);
@@ -83,41 +97,175 @@ auto parseCommon(INPUT& input, flexi_cfg::config::ActionData& output) {
   }
 }
 
-auto mergeNested(const std::vector<flexi_cfg::config::types::CfgMap>& in)
-    -> flexi_cfg::config::types::CfgMap {
-  if (in.empty()) {
-    // TODO(miker2): Throw exception here? How to handle empty vector?
-    return {};
+}  // namespace
+
+namespace flexi_cfg {
+
+namespace {
+/// \brief The result of parsing a single file on its own (see `parseConcurrently`)
+struct FileResult {
+  config::ActionData state;
+  ParseStats stats{};
+  std::int64_t live_nodes{0};
+  /// The messages logged while parsing (only logged once all of the files have been parsed)
+  logger::Messages messages{};
+  bool success{false};
+};
+
+/// \brief Parses a single file, skipping its includes. Nothing is logged here (see
+///        `FileResult::messages`), as a failure is reported by the serial parse that follows.
+void parseFile(const std::filesystem::path& file, bool collect_stats, FileResult& result) {
+  const config::stats::ScopedCollector collector{collect_stats ? &result.stats : nullptr};
+  const logger::ScopedCapture capture{result.messages};
+  try {
+    auto input = result.state.files->open(file).input();
+    const config::stats::ScopedTimer timer{&ParseStats::files, file.string()};
+    result.success =
+        config::internal::parseCore<config::grammar, config::action, config::control>(
+            input, result.state);
+  } catch (const std::exception&) {
+    result.success = false;
   }
+  result.success = result.success && result.state.keys.empty() &&
+                   result.state.flat_keys.empty() && result.state.objects.empty() &&
+                   result.state.obj_res == nullptr;
+  result.live_nodes = config::stats::liveNodes();
+}
 
-  // This whole function is quite inefficient, but it works, which is a start:
+/// \brief Parses a config file and its includes concurrently. The includes are found first, then
+///        each file is parsed on its own and the results are joined up in the order in which the
+///        serial parse would have produced them.
+/// \return The parse result, or `std::nullopt` if the serial parse is needed (e.g. to report an
+///         error, or because joining up the results found a duplicate key)
+/// \note Nothing is logged unless the result is returned, so that the serial parse doesn't repeat
+///       any of the messages.
+auto parseConcurrently(const std::filesystem::path& cfg_file,
+                       const std::filesystem::path& base_dir, unsigned threads)
+    -> std::optional<config::ActionData> {
+  config::ActionData state{base_dir};
+  state.include_mode = config::ActionData::IncludeMode::kDiscover;
+  logger::Messages discovery_messages;
+  try {
+    const logger::ScopedCapture capture{discovery_messages};
+    auto input = state.files->open(cfg_file).input();
+    if (!config::internal::parseCore<peg::seq<config::TAIL, config::includes>, config::action,
+                                     config::control>(input, state)) {
+      return std::nullopt;
+    }
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+  state.include_mode = config::ActionData::IncludeMode::kParse;
+  // The root file is finished after all of its includes.
+  state.include_order.push_back(cfg_file);
+
+  std::vector<FileResult> results;
+  results.reserve(state.include_order.size());
+  for (std::size_t i = 0; i < state.include_order.size(); ++i) {
+    auto& result = results.emplace_back(FileResult{.state = config::ActionData{base_dir}});
+    result.state.files = state.files;
+    result.state.include_mode = config::ActionData::IncludeMode::kSkip;
+  }
 
-  // Start with the first element:
-  flexi_cfg::config::types::CfgMap squashed_cfg = in[0];
+  const bool collect_stats = config::stats::active() != nullptr;
+  std::atomic<std::size_t> next{0};
+  const auto work = [&]() {
+    for (auto i = next++; i < results.size(); i = next++) {
+      parseFile(state.include_order[i], collect_stats, results[i]);
+    }
+  };
+  {
+    std::vector<std::jthread> workers;
+    for (std::size_t i = 1; i < std::min<std::size_t>(threads, results.size()); ++i) {
+      workers.emplace_back(work);
+    }
+    work();
+  }
 
-  // Accumulate all of the other elements of the vector into the CfgMap.
-  for (const auto& cfg : ranges::views::tail(in)) {
-    flexi_cfg::logger::trace(
-        "======= Working on merging: =======\n{}\n"
-        "++++++++++++++ and ++++++++++++++++\n{}",
-        fmt::join(squashed_cfg, "\n"), fmt::join(cfg, "\n"));
+  // The nodes created by the other threads are destroyed on this one, so their stats are needed
+  // even if the results are discarded.
+  for (const auto& result : results) {
+    config::stats::merge(result.stats, result.live_nodes);
+  }
+  if (!std::ranges::all_of(results, &FileResult::success)) {
+    return std::nullopt;
+  }
 
-    squashed_cfg = flexi_cfg::config::helpers::mergeNestedMaps(squashed_cfg, cfg);
+  // In the serial parse, the top level entries at the start of a file are added to (and checked
+  // for duplicates against) the last map of the files before it.
+  for (auto& result : results) {
+    auto& maps = result.state.cfg_res;
+    for (auto& [key, value] : maps.front()) {
+      if (!state.cfg_res.back().try_emplace(key, std::move(value)).second) {
+        return std::nullopt;
+      }
+    }
+    std::move(std::next(maps.begin()), maps.end(), std::back_inserter(state.cfg_res));
+    for (auto& [key, value] : result.state.override_values) {
+      if (!state.override_values.try_emplace(key, std::move(value)).second) {
+        return std::nullopt;
+      }
+    }
+  }
 
-    flexi_cfg::logger::trace(
-        "++++++++++++ result +++++++++++++++\n{}\n"
-        "============== END ================\n",
-        fmt::join(squashed_cfg, "\n"));
+  // Eliminate any vector elements with an empty map.
+  state.cfg_res |= ranges::actions::remove_if(
+      [](const config::types::CfgMap& m) { return m.empty(); });
+
+  logger::replay(discovery_messages);
+  for (const auto& result : results) {
+    logger::replay(result.messages);
   }
-  return squashed_cfg;
+  return state;
 }
-
 }  // namespace
 
-namespace flexi_cfg {
-
 auto Parser::parse(const std::filesystem::path& cfg_filename,
-                   std::optional<std::filesystem::path> root_dir) -> Reader {
+                   std::optional<std::filesystem::path> root_dir, ParseStats* stats,
+                   unsigned threads) -> Reader {
+  if (stats != nullptr) {
+    *stats = {};
+  }
+  const config::stats::ScopedCollector collector{stats};
+  const auto start = std::chrono::steady_clock::now();
+
+  auto state = parseFileToState(cfg_filename, root_dir, threads);
+  const auto parsed = std::chrono::steady_clock::now();
+
+  Parser parser;
+  auto reader = Reader(parser.resolveConfig(state));
+  if (stats != nullptr) {
+    stats->parse = std::chrono::duration_cast<ParseStats::Duration>(parsed - start);
+    stats->total =
+        std::chrono::duration_cast<ParseStats::Duration>(std::chrono::steady_clock::now() - start);
+  }
+  return reader;
+}
+
+auto Parser::parseFromString(std::string_view cfg_string, std::string_view source,
+                             ParseStats* stats) -> Reader {
+  if (stats != nullptr) {
+    *stats = {};
+  }
+  const config::stats::ScopedCollector collector{stats};
+  const auto start = std::chrono::steady_clock::now();
+
+  auto state = parseStringToState(cfg_string, source);
+  const auto parsed = std::chrono::steady_clock::now();
+
+  Parser parser;
+  auto reader = Reader(parser.resolveConfig(state));
+  if (stats != nullptr) {
+    stats->parse = std::chrono::duration_cast<ParseStats::Duration>(parsed - start);
+    stats->total =
+        std::chrono::duration_cast<ParseStats::Duration>(std::chrono::steady_clock::now() - start);
+  }
+  return reader;
+}
+
+auto Parser::parseFileToState(const std::filesystem::path& cfg_filename,
+                              const std::optional<std::filesystem::path>& root_dir,
+                              unsigned threads) -> config::ActionData {
   std::filesystem::path input_file;
   std::filesystem::path base_dir;
   if (root_dir.has_value()) {
@@ -127,78 +275,108 @@ auto Parser::parse(const std::filesystem::path& cfg_filename,
     input_file = cfg_filename;
     base_dir = cfg_filename.parent_path();
   }
-  peg::file_input cfg_file(input_file);
+
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  if (threads > 1) {
+    // If the concurrent parse fails, only the time it took is kept in the stats.
+    auto* stats = config::stats::active();
+    const auto saved = stats != nullptr ? std::optional<ParseStats>{*stats} : std::nullopt;
+    if (auto state = parseConcurrently(input_file, base_dir, threads); state.has_value()) {
+      return std::move(*state);
+    }
+    if (saved.has_value()) {
+      *stats = *saved;
+    }
+  }
+
   config::ActionData state{base_dir};
+  auto cfg_file = state.files->open(input_file).input();
 
+  const config::stats::ScopedTimer timer{&ParseStats::files, input_file.string()};
   // Will throw InvalidConfigException if parsing fails.
   parseCommon(cfg_file, state);
 
-  Parser parser;
-  return Reader(parser.resolveConfig(state));
+  return state;
 }
 
-auto Parser::parseFromString(std::string_view cfg_string, std::string_view source) -> Reader {
+auto Parser::parseStringToState(std::string_view cfg_string, std::string_view source)
+    -> config::ActionData {
   peg::memory_input cfg_file(cfg_string, source);
   config::ActionData state;
 
+  const config::stats::ScopedTimer timer{&ParseStats::files, std::string(source)};
   // Will throw InvalidConfigException if parsing fails.
   parseCommon(cfg_file, state);
 
-  Parser parser;
-  return Reader(parser.resolveConfig(state));
+  return state;
 }
 
 auto Parser::resolveConfig(config::ActionData& state) -> const config::types::CfgMap& {
-  config::types::CfgMap flat{};
-  for (const auto& e : state.cfg_res) {
-    flat = flattenAndFindProtos(e, "", flat);
+  for (const auto phase : magic_enum::enum_values<Phase>()) {
+    const config::stats::ScopedTimer timer{&ParseStats::phases,
+                                           std::string(magic_enum::enum_name(phase).substr(1))};
+    resolvePhase(phase, state);
   }
-  logger::debug("Flattened: \n {}", fmt::join(flat, "\n "));
-
-  logger::debug("Protos: \n  {}", fmt::join(protos_ | ranges::views::keys, "\n  "));
 
-  logger::debug("Overrides: \n {}", fmt::join(state.override_values, "\n "));
+  return cfg_data_;
+}
 
+void Parser::resolvePhase(Phase phase, config::ActionData& state) {
   static const std::string debug_sep(35, '=');
-  logger::debug("{0} Resolving References {0}", debug_sep);
-  // Iterate over each map in the parse results and resolve any references. This is done here
-  // because we don't support combining references & structs, so we need all references to be
-  // resolved to their equivalent struct.
-  for (auto& e : state.cfg_res) {
-    resolveReferences(e, "", {});
-    logger::trace("Resolved results: \n{}", fmt::join(e, "\n"));
-  }
-  logger::debug("{0} Done resolving refs {0}", debug_sep);
-
-  cfg_data_ = mergeNested(state.cfg_res);
-
-  validateAndApplyOverrides(state, cfg_data_);
+  switch (phase) {
+    case Phase::kFlattenAndFindProtos: {
+      config::types::CfgMap flat{};
+      for (const auto& e : state.cfg_res) {
+        flat = flattenAndFindProtos(e, "", flat);
+      }
+      logger::debug("Flattened: \n {}", fmt::join(flat, "\n "));
 
-  if (STRIP_PROTOS) {
-    // Stripping protos is not strictly necessary, but it cleans up the resulting config file.
-    logger::trace("{0} Strip Protos {0}", debug_sep);
-    stripProtos(cfg_data_);
-    logger::trace(" --- Result of 'stripProtos':\n{}", fmt::join(cfg_data_, "\n"));
-  }
+      logger::debug("Protos: \n  {}", fmt::join(protos_ | ranges::views::keys, "\n  "));
 
-  // Unflatten any flat keys:
-  const auto flat_keys =
-      cfg_data_ | ranges::views::keys |
-      ranges::views::filter([](auto& key) { return key.find(".") != std::string::npos; }) |
-      ranges::to<std::vector<std::string>> | ranges::actions::sort | ranges::actions::reverse;
-  logger::debug("The following keys need to be flattened: {}", flat_keys);
-  for (const auto& key : flat_keys) {
-    config::helpers::unflatten(key, cfg_data_);
+      logger::debug("Overrides: \n {}", fmt::join(state.override_values, "\n "));
+      break;
+    }
+    case Phase::kResolveReferences:
+      logger::debug("{0} Resolving References {0}", debug_sep);
+      // Iterate over each map in the parse results and resolve any references. This is done here
+      // because we don't support combining references & structs, so we need all references to be
+      // resolved to their equivalent struct.
+      for (auto& e : state.cfg_res) {
+        resolveReferences(e, "", {});
+        logger::trace("Resolved results: \n{}", fmt::join(e, "\n"));
+      }
+      logger::debug("{0} Done resolving refs {0}", debug_sep);
+      break;
+    case Phase::kMergeNested:
+      cfg_data_ = config::helpers::mergeNested(std::move(state.cfg_res));
+      break;
+    case Phase::kValidateAndApplyOverrides:
+      validateAndApplyOverrides(state, cfg_data_);
+      break;
+    case Phase::kStripProtos:
+      if (STRIP_PROTOS) {
+        // Stripping protos is not strictly necessary, but it cleans up the resulting config file.
+        logger::trace("{0} Strip Protos {0}", debug_sep);
+        stripProtos(cfg_data_);
+        logger::trace(" --- Result of 'stripProtos':\n{}", fmt::join(cfg_data_, "\n"));
+      }
+      break;
+    case Phase::kUnflatten:
+      unflattenKeys(cfg_data_);
+      break;
+    case Phase::kResolveVarRefs:
+      config::helpers::resolveVarRefs(cfg_data_, cfg_data_);
+      break;
+    case Phase::kEvaluateExpressions:
+      config::helpers::evaluateExpressions(cfg_data_);
+      break;
+    case Phase::kCleanupConfig:
+      // Removes empty structs, fixes incorrect depth, etc.
+      config::helpers::cleanupConfig(cfg_data_);
+      break;
   }
-
-  config::helpers::resolveVarRefs(cfg_data_, cfg_data_);
-
-  config::helpers::evaluateExpressions(cfg_data_);
-
-  // Removes empty structs, fixes incorrect depth, etc.
-  config::helpers::cleanupConfig(cfg_data_);
-
-  return cfg_data_;
 }
 
 auto Parser::flattenAndFindProtos(const config::types::CfgMap& in, const std::string& base_name,
@@ -283,7 +461,7 @@ void Parser::resolveReferences(config::types::CfgMap& cfg_map, const std::string
       // Resolve all proto/reference variables based on the values provided.
       config::helpers::replaceProtoVar(new_struct->data, updated_ref_vars);
       // Replace the existing reference with the new struct that was created.
-      cfg_map[k] = new_struct;
+      v = new_struct;
       // Call recursively in case the current reference has another reference
       resolveReferences(new_struct->data, new_name, updated_ref_vars, updated_refd_protos);
 
@@ -313,16 +491,16 @@ void Parser::validateAndApplyOverrides(const config::ActionData& state,
       // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
       auto& data = (struct_like != nullptr) ? struct_like->data : cfg_map;
 
-      const auto parts = utils::split(override.first, '.');
-      if (!data.contains(parts.back())) {
+      const auto found = data.find(utils::splitView(override.first).back());
+      if (found == data.end()) {
         THROW_EXCEPTION(config::InvalidOverrideException,
                         "Override invalid: No default found for '{}' in config file. Defined at {}",
                         override.first, override.second->loc());
       }
       logger::debug("+++ Found default for '{} = {}'. Overriding with {}", override.first,
-                    data.at(parts.back()), override.second);
+                    found->second, override.second);
       // Check that the types match (if possible)
-      const auto& default_type = data.at(parts.back())->type;
+      const auto& default_type = found->second->type;
       const auto& override_type = override.second->type;
       using config::types::Type;
       std::set<Type> checked_types{Type::kString, Type::kNumber, Type::kBoolean, Type::kList,
@@ -338,12 +516,12 @@ void Parser::validateAndApplyOverrides(const config::ActionData& state,
               config::InvalidOverrideException,
               "Override key '{}':{} has type '{}' but expected '{}'. Original key at {}",
               override.first, override.second->loc(), override_type, default_type,
-              data.at(parts.back())->loc());
+              found->second->loc());
         }
       }
 
       // Default value exists and types match. Apply override!
-      data[parts.back()] = override.second;
+      found->second = override.second;
 
     } catch (const config::InvalidKeyException& e) {
       THROW_EXCEPTION(config::InvalidOverrideException,
@@ -363,17 +541,29 @@ void Parser::stripProtos(config::types::CfgMap& cfg_map) const {
   for (const auto& key : keys) {
     logger::debug("Removing '{}' from config.", key);
     // Split the keys so we can use them to recurse into the map.
-    const auto parts = utils::split(key, '.');
+    const auto parts = utils::splitView(key);
 
-    auto& content =
-        parts.size() == 1 ? cfg_map : config::helpers::getNestedConfig(cfg_map, parts)->data;
+    const auto struct_like = config::helpers::getNestedConfig(cfg_map, parts);
+    auto& content = struct_like != nullptr ? struct_like->data : cfg_map;
 
     logger::trace("Final component: \n{}", content.at(parts.back()));
     content.erase(parts.back());
     if (content.empty()) {
-      logger::debug("{} is empty and could be removed.", parts | ranges::views::drop_last(1));
+      logger::debug("{} is empty and could be removed.", utils::getParent(key));
     }
   }
 }
 
+void Parser::unflattenKeys(config::types::CfgMap& cfg_map) {
+  // Unflatten any flat keys:
+  const auto flat_keys =
+      cfg_map | ranges::views::keys |
+      ranges::views::filter([](auto& key) { return key.find(".") != std::string::npos; }) |
+      ranges::to<std::vector<std::string>> | ranges::actions::sort | ranges::actions::reverse;
+  logger::debug("The following keys need to be flattened: {}", flat_keys);
+  for (const auto& key : flat_keys) {
+    config::helpers::unflatten(key, cfg_map);
+  }
+}
+
 }  // namespace flexi_cfg
@@ -1,56 +1,152 @@
 #include <fmt/format.h>
 
-#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <range/v3/range/conversion.hpp>
+#include <sstream>
+#include <stdexcept>
 #include <string>
-#include <typeindex>
-#include <unordered_map>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/classes.h"
 #include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/config/frozen.h"
 #include "flexi_cfg/config/helpers.h"
+#include "flexi_cfg/details/from_chars.h"
 #include "flexi_cfg/logger.h"
 #include "flexi_cfg/reader.h"
 #include "flexi_cfg/utils.h"
 
 namespace {
-// NOLINTBEGIN(cert-err58-cpp)
-const std::unordered_map<std::type_index, std::string_view> type_names = {
-    {{typeid(int)}, "int"},           {{typeid(float)}, "float"},
-    {{typeid(double)}, "double"},     {{typeid(uint8_t)}, "uint8_t"},
-    {{typeid(uint16_t)}, "uint16_t"}, {{typeid(uint32_t)}, "uint32_t"},
-    {{typeid(uint64_t)}, "uint64_t"}, {{typeid(int8_t)}, "int8_t"},
-    {{typeid(int16_t)}, "int16_t"},   {{typeid(int32_t)}, "int32_t"},
-    {{typeid(int64_t)}, "int64_t"},   {{typeid(bool)}, "bool"},
-    {{typeid(std::string)}, "string"}};
-// NOLINTEND(cert-err58-cpp)
+/// \brief The name of a numeric type (for error messages)
+template <typename T>
+constexpr auto typeName() -> std::string_view {
+  if constexpr (std::is_same_v<T, int>) {
+    return "int";
+  } else if constexpr (std::is_same_v<T, float>) {
+    return "float";
+  } else if constexpr (std::is_same_v<T, double>) {
+    return "double";
+  } else if constexpr (std::is_same_v<T, int8_t>) {
+    return "int8_t";
+  } else if constexpr (std::is_same_v<T, int16_t>) {
+    return "int16_t";
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return "int32_t";
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return "int64_t";
+  } else if constexpr (std::is_same_v<T, uint8_t>) {
+    return "uint8_t";
+  } else if constexpr (std::is_same_v<T, uint16_t>) {
+    return "uint16_t";
+  } else if constexpr (std::is_same_v<T, uint32_t>) {
+    return "uint32_t";
+  } else if constexpr (std::is_same_v<T, uint64_t>) {
+    return "uint64_t";
+  } else {
+    return "type_unknown";
+  }
+}
+
+/// \brief The name of the `std::sto*` function that a `T` used to be read with (or nullptr for the
+///        types that were added later). Values of those types that can't be converted are still
+///        reported with the same exceptions (and messages) as before.
+template <typename T>
+constexpr auto stoName() -> const char* {
+  if constexpr (std::is_same_v<T, float>) {
+    return "stof";
+  } else if constexpr (std::is_same_v<T, double>) {
+    return "stod";
+  } else if constexpr (std::is_same_v<T, int>) {
+    return "stoi";
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return "stoll";
+  } else if constexpr (std::is_same_v<T, uint64_t>) {
+    return "stoull";
+  } else {
+    return nullptr;
+  }
+}
+
+/// \brief Reads a decoded number, if it can be represented exactly as a `T`
+template <typename T>
+auto fromNumber(const flexi_cfg::config::types::Number& number, T& value) -> bool {
+  return std::visit(
+      [&value](const auto& n) {
+        using N = std::decay_t<decltype(n)>;
+        if constexpr (std::is_same_v<N, std::monostate>) {
+          return false;
+        } else if constexpr (std::is_floating_point_v<T>) {
+          value = static_cast<T>(n);
+          return true;
+        } else if constexpr (std::is_integral_v<N>) {
+          if (std::in_range<T>(n)) {
+            value = static_cast<T>(n);
+            return true;
+          }
+          return false;
+        } else {
+          // Floating point values are never read as integers.
+          return false;
+        }
+      },
+      number);
+}
 
 /// \brief A helper for converting strings to numeric values
-/// \param[in] value_ptr A reference to a ValuePtr object
-/// \param[in/out] value The object in which to read the ValuePtr result
-/// \param[in] type_str String representation of the value type
-/// \param[in] converter The function that will convert from a string to the specified type (e.g.
-/// std::stoi, std::stod, etc)
+/// \param[in] type The type of the config value
+/// \param[in] value_str The config value (as a string)
+/// \param[in] number The decoded config value (if available)
+/// \param[in/out] value The object in which to read the result
 template <typename T>
-void numericConversionHelper(const flexi_cfg::config::types::ValuePtr& value_ptr, T& value,
-                             std::function<T(const std::string&, std::size_t*)> converter) {
-  if (value_ptr->type != flexi_cfg::config::types::Type::kNumber) {
+void numericConversionHelper(flexi_cfg::config::types::Type type, std::string_view value_str,
+                             const flexi_cfg::config::types::Number& number, T& value) {
+  if (type != flexi_cfg::config::types::Type::kNumber) {
     THROW_EXCEPTION(flexi_cfg::config::MismatchTypeException,
-                    "Expected numeric type, but have '{}' type.", value_ptr->type);
+                    "Expected numeric type, but have '{}' type.", type);
+  }
+  if (fromNumber(number, value)) {
+    return;
+  }
+  // Anything that can't be represented exactly goes through the text, in order to produce the
+  // appropriate error (e.g. reading a float as an integer).
+  if constexpr (std::is_unsigned_v<T>) {
+    if (value_str.starts_with('-')) {
+      THROW_EXCEPTION(flexi_cfg::config::MismatchTypeException,
+                      "Expected unsigned type, but found negative number: {}", value_str);
+    }
   }
 
-  std::size_t len{0};
-  value = converter(value_ptr->value, &len);
+  const auto [len, ec] = flexi_cfg::details::fromChars(value_str, value);
+  if (ec == std::errc::invalid_argument) {
+    if constexpr (stoName<T>() != nullptr) {
+      throw std::invalid_argument(stoName<T>());
+    }
+    THROW_EXCEPTION(std::invalid_argument, "Unable to convert '{}' to type {}.", value_str,
+                    typeName<T>());
+  }
+  if (ec == std::errc::result_out_of_range) {
+    if constexpr (stoName<T>() != nullptr) {
+      throw std::out_of_range(stoName<T>());
+    }
+    THROW_EXCEPTION(std::out_of_range, "'{}' is out of range for type {}.", value_str,
+                    typeName<T>());
+  }
 
-  if (len != value_ptr->value.size()) {
-    const std::type_index type_idx(typeid(T));
-    const auto& type_str = type_names.contains(type_idx) ? type_names.at(type_idx) : "type_unknown";
+  if (len != value_str.size()) {
     THROW_EXCEPTION(flexi_cfg::config::MismatchTypeException,
                     "Error while converting '{}' to type {}. Processed {} of {} characters",
-                    value_ptr->value, type_str, len, value_ptr->value.size());
+                    value_str, typeName<T>(), len, value_str.size());
   }
 }
 }  // namespace
@@ -58,13 +154,26 @@ void numericConversionHelper(const flexi_cfg::config::types::ValuePtr& value_ptr
 namespace flexi_cfg {
 
 Reader::Reader(config::types::CfgMap cfg, std::string parent)
+    : Reader(std::make_shared<const config::types::CfgMap>(std::move(cfg)), std::move(parent)) {}
+
+Reader::Reader(std::shared_ptr<const config::types::CfgMap> cfg, std::string parent)
     : cfg_data_(std::move(cfg)), parent_name_(std::move(parent)) {}
 
 void Reader::dump() const { dump(std::cout); }
 
-void Reader::dump(std::ostream& os) const { os << cfg_data_; }
+void Reader::dump(std::ostream& os) const { os << *cfg_data_; }
 
-auto Reader::exists(const std::string& key) const -> bool {
+void Reader::freeze() {
+  if (!frozen_) {
+    frozen_ = std::make_shared<const config::types::FrozenCfg>(cfg_data_);
+    root_ = config::types::FrozenCfg::root;
+  }
+}
+
+auto Reader::exists(std::string_view key) const -> bool {
+  if (frozen_) {
+    return frozen_->find(root_, key).has_value();
+  }
   try {
     const auto [final_key, data] = getNestedConfig(key);
     return data.find(final_key) != std::end(data);
@@ -78,19 +187,27 @@ auto Reader::exists(const std::string& key) const -> bool {
 }
 
 auto Reader::keys() const -> std::vector<std::string> {
-  return cfg_data_ | ranges::views::keys | ranges::to<std::vector<std::string>>;
+  if (frozen_) {
+    std::vector<std::string> keys;
+    for (const auto idx : frozen_->children(root_)) {
+      keys.emplace_back(frozen_->key(idx));
+    }
+    return keys;
+  }
+  return *cfg_data_ | ranges::views::keys | ranges::to<std::vector<std::string>>;
 }
 
-auto Reader::getType(const std::string& key) const -> config::types::Type {
-  // Split the key into parts
-  const auto keys = utils::split(key, '.');
+auto Reader::getType(std::string_view key) const -> config::types::Type {
+  if (frozen_) {
+    return frozen_->type(frozen_->get(root_, key));
+  }
 
-  const auto cfg_val = config::helpers::getConfigValue(cfg_data_, keys);
+  const auto cfg_val = config::helpers::getConfigValue(*cfg_data_, utils::splitView(key));
 
   return cfg_val->type;
 }
 
-auto Reader::findStructsWithKey(const std::string& key) const -> std::vector<std::string> {
+auto Reader::findStructsWithKey(std::string_view key) const -> std::vector<std::string> {
   std::vector<std::string> structs{};
 
   std::function<void(const std::string&, const config::types::CfgMap&)> contains_key =
@@ -110,21 +227,41 @@ auto Reader::findStructsWithKey(const std::string& key) const -> std::vector<std
         }
       };
 
-  contains_key("", cfg_data_);
+  if (frozen_) {
+    std::function<void(const std::string&, config::types::FrozenCfg::Index)> frozen_contains_key =
+        [this, &key = std::as_const(key), &structs, &frozen_contains_key](
+            const std::string& root, config::types::FrozenCfg::Index idx) {
+          for (const auto child : frozen_->children(idx)) {
+            const auto& k = frozen_->key(child);
+            if (k == key) {
+              logger::trace("Found key: '{}' in '{}'", k, root);
+              structs.emplace_back(root);
+            }
+
+            if (frozen_->isStructLike(child)) {
+              frozen_contains_key(utils::makeName(root, k), child);
+            }
+          }
+        };
+    frozen_contains_key("", root_);
+    return structs;
+  }
+
+  contains_key("", *cfg_data_);
   return structs;
 }
 
-auto Reader::getNestedConfig(const std::string& key) const
-    -> std::pair<std::string, const config::types::CfgMap&> {
+auto Reader::getNestedConfig(std::string_view key) const
+    -> std::pair<std::string_view, const config::types::CfgMap&> {
   // Split the key into parts
-  const auto keys = utils::split(key, '.');
+  const auto keys = utils::splitView(key);
 
   try {
-    const auto struct_like = config::helpers::getNestedConfig(cfg_data_, keys);
+    const auto struct_like = config::helpers::getNestedConfig(*cfg_data_, keys);
 
     // Special handling for the case where 'key' contains a single key (i.e is not a flat key)
     // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
-    const auto& data = (struct_like != nullptr) ? struct_like->data : cfg_data_;
+    const auto& data = (struct_like != nullptr) ? struct_like->data : *cfg_data_;
 
     return {keys.back(), data};
   } catch (config::Exception& e) {
@@ -136,57 +273,148 @@ auto Reader::getNestedConfig(const std::string& key) const
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, float& value) {
-  numericConversionHelper<float>(value_ptr, value,
-                                 [](const auto& str, auto* l) { return std::stof(str, l); });
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, double& value) {
-  numericConversionHelper<double>(value_ptr, value,
-                                  [](const auto& str, auto* l) { return std::stod(str, l); });
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, int8_t& value) {
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, int16_t& value) {
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, int& value) {
-  numericConversionHelper<int>(value_ptr, value,
-                               [](const auto& str, auto* l) { return std::stoi(str, l, 0); });
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, int64_t& value) {
-  numericConversionHelper<int64_t>(value_ptr, value,
-                                   [](const auto& str, auto* l) { return std::stoll(str, l, 0); });
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, uint8_t& value) {
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, uint16_t& value) {
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, uint32_t& value) {
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, uint64_t& value) {
-  auto strict_stoull = [](const auto& str, auto* l) {
-    if (str[0] == '-') {
-      THROW_EXCEPTION(config::MismatchTypeException,
-                      "Expected unsigned type, but found negative number: {}", str);
-    }
-    return std::stoull(str, l, 0);
-  };
-  numericConversionHelper<uint64_t>(value_ptr, value, strict_stoull);
+  convert(value_ptr->type, value_ptr->value, value, value_ptr->number);
 }
 
 void Reader::convert(const config::types::ValuePtr& value_ptr, bool& value) {
-  if (value_ptr->type != config::types::Type::kBoolean) {
+  convert(value_ptr->type, value_ptr->value, value);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, std::string& value) {
+  convert(value_ptr->type, value_ptr->unquoted(), value);
+}
+
+void Reader::convert(const config::types::ValuePtr& value_ptr, std::string_view& value) {
+  convert(value_ptr->type, value_ptr->unquoted(), value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, float& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, double& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, int8_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, int16_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, int& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, int64_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, uint8_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, uint16_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, uint32_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, uint64_t& value,
+                     const config::types::Number& number) {
+  numericConversionHelper(type, value_str, number, value);
+}
+
+void Reader::convert(config::types::Type type, std::string_view value_str, bool& value) {
+  if (type != config::types::Type::kBoolean) {
     THROW_EXCEPTION(config::MismatchTypeException, "Expected boolean type, but have '{}' type.",
-                    value_ptr->type);
+                    type);
   }
-  value = value_ptr->value == "true";
+  value = value_str == "true";
 }
 
-void Reader::convert(const config::types::ValuePtr& value_ptr, std::string& value) {
-  if (value_ptr->type != config::types::Type::kString) {
+void Reader::convert(config::types::Type type, std::string_view value_str, std::string& value) {
+  if (type != config::types::Type::kString) {
     THROW_EXCEPTION(config::MismatchTypeException, "Expected string type, but have '{}' type.",
-                    value_ptr->type);
+                    type);
   }
-  value = value_ptr->value;
-  value.erase(std::remove(std::begin(value), std::end(value), '\"'), std::end(value));
+  value = value_str;
 }
 
-void Reader::getValue(const std::string& key, Reader& reader) const {
-  // Split the key into parts
-  const auto keys = utils::split(key, '.');
-  auto cfg_value = config::helpers::getConfigValue(cfg_data_, keys);
+void Reader::convert(config::types::Type type, std::string_view value_str,
+                     std::string_view& value) {
+  if (type != config::types::Type::kString) {
+    THROW_EXCEPTION(config::MismatchTypeException, "Expected string type, but have '{}' type.",
+                    type);
+  }
+  value = value_str;
+}
+
+void Reader::getValue(std::string_view key, Reader& reader) const {
+  // Neither the map of the struct nor the frozen copy are ever copied. The sub-reader shares them.
+  if (frozen_) {
+    const auto idx = frozen_->get(root_, key);
+    if (!frozen_->isStructLike(idx)) {
+      THROW_EXCEPTION(config::MismatchTypeException,
+                      "Expected struct type when reading {}, but have '{}' type.",
+                      utils::makeName(parent_name_, key), frozen_->type(idx));
+    }
+    reader = Reader(frozen_->map(idx), std::string(key));
+    reader.frozen_ = frozen_;
+    reader.root_ = idx;
+    return;
+  }
+
+  auto cfg_value = config::helpers::getConfigValue(*cfg_data_, utils::splitView(key));
   const auto struct_like = dynamic_pointer_cast<config::types::ConfigStructLike>(cfg_value);
   if (struct_like == nullptr) {
     // throw an exception here
@@ -195,7 +423,167 @@ void Reader::getValue(const std::string& key, Reader& reader) const {
                     utils::makeName(parent_name_, key), cfg_value->type);
   }
 
-  reader = Reader(struct_like->data, key);
+  // The map is owned by the struct, so the struct is kept alive along with it.
+  reader =
+      Reader(std::shared_ptr<const config::types::CfgMap>(struct_like, &struct_like->data),
+             std::string(key));
+}
+
+auto Reader::getShape(std::string_view key) const -> Shape {
+  try {
+    return shape(list(key));
+  } catch (config::Exception& e) {
+    e.prepend(fmt::format("[Error] While reading '{}':\n", utils::makeName(parent_name_, key)));
+    throw;
+  }
+}
+
+auto Reader::list(std::string_view key) const -> ListRef {
+  ListRef ref{};
+  config::types::Type type{};
+  if (frozen_) {
+    ref.idx = index(key);
+    type = frozen_->type(*ref.idx);
+  } else {
+    // NOTE: The node is owned by `cfg_data_`, so a plain pointer is enough.
+    ref.node = lookup(key).get();
+    type = ref.node->type;
+  }
+  if (type != config::types::Type::kList) {
+    THROW_EXCEPTION(config::InvalidTypeException,
+                    "Expected '{}' to contain a list, but is of type {}",
+                    utils::makeName(parent_name_, key), type);
+  }
+  return ref;
+}
+
+auto Reader::shape(const ListRef& list) const -> Shape {
+  // The shape is determined by the first element at each depth. Every other element is then
+  // checked against it.
+  Shape shape{};
+  if (list.idx) {
+    auto idx = *list.idx;
+    while (frozen_->type(idx) == config::types::Type::kList) {
+      const auto children = frozen_->children(idx);
+      shape.push_back(children.size());
+      if (children.empty()) {
+        break;
+      }
+      idx = children.front();
+    }
+  } else {
+    const auto* node = list.node;
+    while (node->type == config::types::Type::kList) {
+      const auto& list = dynamic_cast<const config::types::ConfigList&>(*node);
+      shape.push_back(list.size());
+      // NOTE: The elements of a packed list are never lists themselves.
+      if (list.size() == 0 || list.packed() != nullptr) {
+        break;
+      }
+      node = list.nodes().front().get();
+    }
+  }
+
+  const auto check = [&shape](std::size_t depth, config::types::Type type, std::size_t size,
+                              const auto& str) {
+    const bool is_list = type == config::types::Type::kList;
+    if (depth < shape.size() && !is_list) {
+      THROW_EXCEPTION(config::InvalidTypeException, "Expected '{}' type but got '{}' type.",
+                      config::types::Type::kList, type);
+    }
+    if (depth >= shape.size() && is_list) {
+      THROW_EXCEPTION(config::InvalidTypeException, "Expected a value, but got '{}' type.", type);
+    }
+    if (is_list && size != shape[depth]) {
+      THROW_EXCEPTION(config::Exception, "Expected {} entries in '{}', but found {}!",
+                      shape[depth], str(), size);
+    }
+  };
+  if (list.idx) {
+    std::function<void(FrozenCfg::Index, std::size_t)> check_frozen =
+        [this, &check, &check_frozen](FrozenCfg::Index idx, std::size_t depth) {
+          const auto type = frozen_->type(idx);
+          const auto children = frozen_->children(idx);
+          check(depth, type, children.size(), [this, idx] { return frozen_->str(idx); });
+          if (type == config::types::Type::kList) {
+            for (const auto child : children) {
+              check_frozen(child, depth + 1);
+            }
+          }
+        };
+    check_frozen(*list.idx, 0);
+  } else {
+    std::function<void(const config::types::ConfigBase&, std::size_t)> check_node =
+        [&check, &check_node](const config::types::ConfigBase& node, std::size_t depth) {
+          const auto* list = dynamic_cast<const config::types::ConfigList*>(&node);
+          const auto size = list != nullptr ? list->size() : 0;
+          check(depth, node.type, size, [&node] {
+            std::stringstream ss;
+            node.stream(ss);
+            return ss.str();
+          });
+          if (const auto* packed = list != nullptr ? list->packed() : nullptr; packed) {
+            // All of the elements of a packed list are values of the same type, so checking one
+            // is enough (and doesn't require a node).
+            if (size > 0) {
+              check(depth + 1, packed->type(), 0,
+                    [packed] { return std::string(packed->text(0)); });
+            }
+          } else if (list != nullptr) {
+            for (const auto& element : list->nodes()) {
+              check_node(*element, depth + 1);
+            }
+          }
+        };
+    check_node(*list.node, 0);
+  }
+  return shape;
+}
+
+auto Reader::key(std::string key) const -> Key {
+  Key handle{std::move(key)};
+  try {
+    handle.data_ = cfg_data_;
+    if (frozen_) {
+      handle.cfg_ = frozen_;
+      handle.root_ = root_;
+      handle.idx_ = frozen_->get(root_, handle.str());
+    } else {
+      handle.node_ = lookup(std::string_view{handle.str()});
+    }
+  } catch (config::Exception& e) {
+    e.prepend(fmt::format("[Error] While reading '{}':\n",
+                          utils::makeName(parent_name_, handle.str())));
+    throw;
+  }
+  return handle;
+}
+
+auto Reader::index(std::string_view key) const -> FrozenCfg::Index {
+  return frozen_->get(root_, key);
+}
+
+auto Reader::index(const Key& key) const -> FrozenCfg::Index {
+  if (key.cfg_ == frozen_ && key.root_ == root_) {
+    return key.idx_;
+  }
+  return frozen_->get(root_, key.str());
+}
+
+auto Reader::lookup(std::string_view key) const -> config::types::BasePtr {
+  return config::helpers::getConfigValue(*cfg_data_, utils::splitView(key));
+}
+
+auto Reader::lookup(const Key& key) const -> config::types::BasePtr {
+  if (key.node_ != nullptr && key.data_ == cfg_data_) {
+    return key.node_;
+  }
+  return config::helpers::getConfigValue(*cfg_data_, utils::splitView(key.str()));
+}
+
+auto Reader::owns(const Key& key) const -> bool {
+  return key.data_ == cfg_data_ ||
+         (frozen_ != nullptr && key.cfg_ == frozen_ && key.root_ == root_);
 }
 
 }  // namespace flexi_cfg
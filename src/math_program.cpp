@@ -0,0 +1,169 @@
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tao/pegtl.hpp>
+#include <vector>
+
+#include "flexi_cfg/config/exceptions.h"
+#include "flexi_cfg/config/grammar.h"
+#include "flexi_cfg/config/parser-internal.h"
+#include "flexi_cfg/math/actions.h"
+#include "flexi_cfg/math/grammar.h"
+#include "flexi_cfg/math/program.h"
+
+namespace {
+
+using Op = flexi_cfg::math::Program::Op;
+
+// NOTE: These must match the precedence & associativity used by `math::Stack` (see
+// `math_helpers.cpp`).
+constexpr auto precedence(Op op) -> int {
+  switch (op) {
+    case Op::kAdd:
+    case Op::kSub:
+      return 6;
+    case Op::kMul:
+    case Op::kDiv:
+      return 8;
+    case Op::kPow:
+      return 9;
+    case Op::kNeg:
+      return 10;
+    default:
+      return -1;
+  }
+}
+
+constexpr auto leftAssociative(Op op) -> bool { return op != Op::kPow && op != Op::kNeg; }
+
+}  // namespace
+
+namespace flexi_cfg::math {
+
+auto Program::evaluate(std::span<const double> slot_values) const -> double {
+  if (slot_values.size() != slots.size()) {
+    THROW_EXCEPTION(std::runtime_error, "Expected {} values for [{}], but received {}.",
+                    slots.size(), fmt::join(slots, ", "), slot_values.size());
+  }
+  std::vector<double> stack(max_depth);
+  std::size_t n = 0;  // The current depth of the stack
+  for (const auto& inst : code) {
+    switch (inst.op) {
+      case Op::kConstant:
+        stack[n++] = constants[inst.arg];
+        break;
+      case Op::kSlot:
+        stack[n++] = slot_values[inst.arg];
+        break;
+      case Op::kNeg:
+        stack[n - 1] = -stack[n - 1];
+        break;
+      case Op::kAdd:
+        --n;
+        stack[n - 1] = stack[n - 1] + stack[n];
+        break;
+      case Op::kSub:
+        --n;
+        stack[n - 1] = stack[n - 1] - stack[n];
+        break;
+      case Op::kMul:
+        --n;
+        stack[n - 1] = stack[n - 1] * stack[n];
+        break;
+      case Op::kDiv:
+        --n;
+        stack[n - 1] = stack[n - 1] / stack[n];
+        break;
+      case Op::kPow:
+        --n;
+        stack[n - 1] = std::pow(stack[n - 1], stack[n]);
+        break;
+    }
+  }
+  // NOLINTNEXTLINE
+  assert(n == 1);
+  return stack.front();
+}
+
+ProgramBuilder::ProgramBuilder() { open(); }
+
+void ProgramBuilder::pushConstant(double v) {
+  // Constants are not de-duplicated. Expressions are short, so it isn't worth the effort.
+  emit(Op::kConstant, static_cast<uint32_t>(program_.constants.size()));
+  program_.constants.push_back(v);
+}
+
+void ProgramBuilder::pushSlot(const std::string& var_ref) {
+  auto& slots = program_.slots;
+  const auto it = std::find(slots.begin(), slots.end(), var_ref);
+  const auto idx = static_cast<uint32_t>(std::distance(slots.begin(), it));
+  if (it == slots.end()) {
+    slots.push_back(var_ref);
+  }
+  emit(Op::kSlot, idx);
+}
+
+void ProgramBuilder::pushOperator(Program::Op op) {
+  // See `math::Stack::push` (the shunting yard algorithm).
+  auto& ops = ops_.back();
+  while (!ops.empty() && (precedence(ops.back()) > precedence(op) ||
+                          (precedence(ops.back()) == precedence(op) && leftAssociative(op)))) {
+    emit(ops.back());
+    ops.pop_back();
+  }
+  ops.push_back(op);
+}
+
+void ProgramBuilder::open() { ops_.emplace_back(); }
+
+void ProgramBuilder::close() {
+  // NOLINTNEXTLINE
+  assert(ops_.size() > 1);
+  flush();
+  ops_.pop_back();
+}
+
+auto ProgramBuilder::finish() -> Program {
+  // NOLINTNEXTLINE
+  assert(ops_.size() == 1);
+  flush();
+  return std::move(program_);
+}
+
+void ProgramBuilder::emit(Program::Op op, uint32_t arg) {
+  program_.code.push_back({op, arg});
+  if (op == Op::kConstant || op == Op::kSlot) {
+    program_.max_depth = std::max(program_.max_depth, ++depth_);
+  } else if (op != Op::kNeg) {
+    --depth_;
+  }
+}
+
+void ProgramBuilder::flush() {
+  auto& ops = ops_.back();
+  while (!ops.empty()) {
+    emit(ops.back());
+    ops.pop_back();
+  }
+}
+
+auto compile(const std::string& expression, const std::string& source)
+    -> std::shared_ptr<const Program> {
+  peg::memory_input input(expression, source);
+  CompileData out;
+  if (!config::internal::parseCore<peg::seq<config::Eo, math::expression, config::Ec>,
+                                   math::compile_action>(input, out)) {
+    THROW_EXCEPTION(std::runtime_error, "Unable to compile expression '{}' from {}.", expression,
+                    source);
+  }
+  return std::make_shared<const Program>(std::move(out.program));
+}
+
+}  // namespace flexi_cfg::math
@@ -383,3 +383,22 @@ TEST(IncludeTests, OptionalMissingAllIncludesIsFine) {
   auto in_cfg = std::filesystem::path(EXAMPLE_DIR) / "optional/optional_config3.cfg";
   EXPECT_NO_THROW(parse(in_cfg));
 }
+
+TEST(IncludeTests, FileTable) {
+  // Each file is read once, into the file table shared by the whole parse.
+  const auto in_file = std::filesystem::path(EXAMPLE_DIR) / "config_example5.cfg";
+  flexi_cfg::config::ActionData out{in_file.parent_path()};
+  auto in_cfg = out.files->open(in_file).input();
+  setLevel(flexi_cfg::logger::Severity::WARN);
+  ASSERT_TRUE((flexi_cfg::config::internal::parseCore<peg::must<flexi_cfg::config::grammar>,
+                                                      flexi_cfg::config::action>(in_cfg, out)));
+
+  ASSERT_EQ(out.all_files.size(), 2U);
+  for (const auto& file : out.all_files) {
+    const auto found = out.files->find(file.string());
+    ASSERT_TRUE(found.has_value()) << file;
+    EXPECT_EQ(found->source, file.string());
+    EXPECT_EQ(found->contents.data(), out.files->open(file).contents.data());
+  }
+  EXPECT_FALSE(out.files->find("not_a_file.cfg").has_value());
+}
@@ -0,0 +1,138 @@
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "flexi_cfg/generator.h"
+#include "flexi_cfg/logger.h"
+#include "flexi_cfg/parser.h"
+#include "flexi_cfg/reader.h"
+#include "flexi_cfg/visitor.h"
+
+namespace {
+
+/// \brief Counts the leaf keys of a config. Every key is either a leaf or a struct.
+class KeyCounter {
+ public:
+  void onKey(const std::string& /*key*/) { keys_++; }
+  void onValue(const std::string& /*value*/) {}
+  void onValue(int64_t /*value*/) {}
+  void onValue(uint64_t /*value*/) {}
+  void onValue(double /*value*/) {}
+  void onValue(bool /*value*/) {}
+  void beginStruct() { structs_++; }
+  void endStruct() {}
+  void beginList() {}
+  void endList() {}
+
+  // The root struct doesn't have a key.
+  [[nodiscard]] auto leafCount() const -> std::size_t { return keys_ - (structs_ - 1); }
+
+ private:
+  std::size_t keys_{0};
+  std::size_t structs_{0};
+};
+
+auto leafCount(const flexi_cfg::Reader& cfg) -> std::size_t {
+  KeyCounter counter;
+  cfg.visit(counter);
+  return counter.leafCount();
+}
+
+auto outputDir(const std::string& name) -> std::filesystem::path {
+  return std::filesystem::temp_directory_path() / "flexi_cfg_generator_test" / name;
+}
+
+}  // namespace
+
+TEST(ConfigGenerator, Deterministic) {
+  flexi_cfg::generator::Options options;
+  options.seed = 42;
+  options.include_files = 2;
+
+  const auto first = flexi_cfg::generator::generate(options);
+  const auto second = flexi_cfg::generator::generate(options);
+  EXPECT_EQ(first.files, second.files);
+  EXPECT_EQ(first.key_count, second.key_count);
+
+  options.seed = 43;
+  const auto other = flexi_cfg::generator::generate(options);
+  EXPECT_NE(first.files, other.files);
+  EXPECT_EQ(first.key_count, other.key_count);
+}
+
+TEST(ConfigGenerator, ParseFromString) {
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::WARN);
+  for (std::uint64_t seed = 0; seed < 5; ++seed) {
+    flexi_cfg::generator::Options options;
+    options.seed = seed;
+    options.structs = 5;
+    options.depth = 3;
+    options.overrides = 3;
+
+    const auto generated = flexi_cfg::generator::generate(options);
+    ASSERT_EQ(generated.files.size(), 1U);
+    flexi_cfg::Reader cfg;
+    ASSERT_NO_THROW(cfg = flexi_cfg::parseFromString(generated.root(), "generated"))
+        << generated.root();
+    EXPECT_EQ(leafCount(cfg), generated.key_count);
+  }
+}
+
+TEST(ConfigGenerator, ParseWithIncludes) {
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::WARN);
+  flexi_cfg::generator::Options options;
+  options.structs = 12;
+  options.include_files = 4;
+
+  const auto generated = flexi_cfg::generator::generate(options);
+  ASSERT_EQ(generated.files.size(), 5U);
+  const auto root = generated.write(outputDir("includes"));
+  flexi_cfg::Reader cfg;
+  ASSERT_NO_THROW(cfg = flexi_cfg::parse(root));
+  EXPECT_EQ(leafCount(cfg), generated.key_count);
+
+  // The same config, with the files parsed concurrently.
+  ASSERT_NO_THROW(cfg = flexi_cfg::parse(root, std::nullopt, nullptr, 4));
+  EXPECT_EQ(leafCount(cfg), generated.key_count);
+}
+
+TEST(ConfigGenerator, KeyCount) {
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::WARN);
+  for (const std::size_t n_keys : {1000, 2000}) {
+    const auto options = flexi_cfg::generator::optionsForKeyCount(n_keys);
+    const auto generated = flexi_cfg::generator::generate(options);
+    EXPECT_NEAR(static_cast<double>(generated.key_count), static_cast<double>(n_keys),
+                0.1 * static_cast<double>(n_keys));
+
+    const auto root = generated.write(outputDir(fmt::format("keys_{}", n_keys)));
+    flexi_cfg::Reader cfg;
+    ASSERT_NO_THROW(cfg = flexi_cfg::parse(root));
+    EXPECT_EQ(leafCount(cfg), generated.key_count);
+  }
+}
+
+TEST(ConfigGenerator, InvalidOptions) {
+  {
+    flexi_cfg::generator::Options options;
+    options.structs = 2;
+    options.include_files = 2;
+    EXPECT_THROW(flexi_cfg::generator::generate(options), std::invalid_argument);
+  }
+  {
+    flexi_cfg::generator::Options options;
+    options.structs = 0;
+    EXPECT_THROW(flexi_cfg::generator::generate(options), std::invalid_argument);
+  }
+  {
+    flexi_cfg::generator::Options options;
+    options.structs = 1;
+    options.depth = 1;
+    options.keys_per_struct = 1;
+    options.overrides = 10;
+    EXPECT_THROW(flexi_cfg::generator::generate(options), std::invalid_argument);
+  }
+}
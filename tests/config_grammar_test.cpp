@@ -5,7 +5,9 @@
 #include <algorithm>
 #include <iosfwd>
 #include <optional>
+#include <sstream>
 #include <tao/pegtl/contrib/analyze.hpp>
+#include <variant>
 
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/classes.h"
@@ -54,6 +56,9 @@ TEST(ConfigGrammar, HEX) {
     checkResult<peg::must<flexi_cfg::config::HEX, peg::eolf>,
                 flexi_cfg::config::types::ConfigValue>(
         input, flexi_cfg::config::types::Type::kNumber, out);
+    const auto value = dynamic_pointer_cast<flexi_cfg::config::types::ConfigValue>(out->obj_res);
+    ASSERT_TRUE(std::holds_alternative<int64_t>(value->number));
+    EXPECT_EQ(std::get<int64_t>(value->number), std::stoll(input, nullptr, 16));
   };
   {
     const std::string content = "0x0";
@@ -107,6 +112,8 @@ TEST(ConfigGrammar, INTEGER) {
     const auto value = dynamic_pointer_cast<flexi_cfg::config::types::ConfigValue>(out->obj_res);
     ASSERT_NO_THROW(std::any_cast<int>(value->value_any));
     EXPECT_EQ(std::any_cast<int>(value->value_any), std::stoi(input));
+    ASSERT_TRUE(std::holds_alternative<int64_t>(value->number));
+    EXPECT_EQ(std::get<int64_t>(value->number), std::stoi(input));
   };
   {
     const std::string content = "-1001";
@@ -160,6 +167,8 @@ TEST(ConfigGrammar, FLOAT) {
     const auto value = dynamic_pointer_cast<flexi_cfg::config::types::ConfigValue>(out->obj_res);
     ASSERT_NO_THROW(std::any_cast<double>(value->value_any));
     EXPECT_EQ(std::any_cast<double>(value->value_any), std::stod(input));
+    ASSERT_TRUE(std::holds_alternative<double>(value->number));
+    EXPECT_EQ(std::get<double>(value->number), std::stod(input));
   };
   {
     const std::string content = "1234.";
@@ -457,6 +466,87 @@ TEST(ConfigGrammar, LIST) {
   }
 }
 
+TEST(ConfigGrammar, PackedLIST) {
+  using flexi_cfg::config::types::ConfigList;
+  using flexi_cfg::config::types::ConfigValue;
+  auto parseList = [](const std::string& input) -> std::shared_ptr<ConfigList> {
+    const auto ret = runTest<peg::must<flexi_cfg::config::LIST, peg::eolf>>(input);
+    EXPECT_TRUE(ret.first) << "INPUT: '" << input << "'";
+    return dynamic_pointer_cast<ConfigList>(ret.second.obj_res);
+  };
+  auto str = [](const auto& list) {
+    std::stringstream ss;
+    ss << *list;
+    return ss.str();
+  };
+  {
+    // Integers (including hex) are packed, and the text of each element is retained.
+    const auto list = parseList("[1, 0x10, -3]");
+    ASSERT_NE(list->packed(), nullptr);
+    EXPECT_THROW(std::ignore = list->nodes(), flexi_cfg::config::InvalidStateException);
+    EXPECT_EQ(list->size(), 3U);
+    EXPECT_EQ(std::get<std::vector<int64_t>>(list->packed()->values()),
+              (std::vector<int64_t>{1, 16, -3}));
+    EXPECT_EQ(str(list), "[1, 0x10, -3]");
+  }
+  {
+    const auto list = parseList("[1.0, 2.50, -1e3]");
+    ASSERT_NE(list->packed(), nullptr);
+    EXPECT_EQ(std::get<std::vector<double>>(list->packed()->values()),
+              (std::vector<double>{1.0, 2.5, -1e3}));
+    EXPECT_EQ(str(list), "[1.0, 2.50, -1e3]");
+    // Nodes are created on demand, and are identical to the nodes that weren't packed.
+    const auto element = dynamic_pointer_cast<ConfigValue>(list->at(1));
+    ASSERT_NE(element, nullptr);
+    EXPECT_EQ(element->type, flexi_cfg::config::types::Type::kNumber);
+    EXPECT_EQ(element->value, "2.50");
+    EXPECT_EQ(std::get<double>(element->number), 2.5);
+    EXPECT_EQ(std::any_cast<double>(element->value_any), 2.5);
+  }
+  {
+    const auto list = parseList("[true, false]");
+    ASSERT_NE(list->packed(), nullptr);
+    EXPECT_EQ(list->packed()->type(), flexi_cfg::config::types::Type::kBoolean);
+    EXPECT_EQ(std::get<std::vector<bool>>(list->packed()->values()),
+              (std::vector<bool>{true, false}));
+    EXPECT_EQ(str(list), "[true, false]");
+  }
+  {
+    // A copy is packed too
+    const auto list = dynamic_pointer_cast<ConfigList>(parseList("[1, 2]")->clone());
+    ASSERT_NE(list->packed(), nullptr);
+    EXPECT_EQ(list->size(), 2U);
+  }
+  // Anything else falls back to a node per element.
+  for (const std::string content : {"[1, 2.5]", R"(["a", "b"])", "[3.456, $(ref.var1)]",
+                                     "[{{ 2^14 - 1}}, 0.32]", "[[1], [2]]"}) {
+    const auto list = parseList(content);
+    EXPECT_EQ(list->packed(), nullptr) << "INPUT: '" << content << "'";
+    EXPECT_EQ(list->nodes().size(), 2U) << "INPUT: '" << content << "'";
+  }
+  EXPECT_EQ(str(parseList("[1, 2.5]")), "[1, 2.5]");
+  {
+    const auto list = parseList("[[1, 2], [3, 4]]");
+    ASSERT_EQ(list->nodes().size(), 2U);
+    EXPECT_NE(dynamic_pointer_cast<ConfigList>(list->nodes().front())->packed(), nullptr);
+  }
+  {
+    // The location of each element is kept, whether or not it stays packed.
+    const auto packed = parseList("[1,\n 2,\n 3]");
+    ASSERT_NE(packed->packed(), nullptr);
+    EXPECT_EQ(packed->packed()->line(0), 1U);
+    EXPECT_EQ(packed->packed()->line(2), 3U);
+    EXPECT_EQ(packed->at(1)->line, 2U);
+    const auto unpacked = parseList("[1,\n 2,\n 3.5]");
+    ASSERT_EQ(unpacked->packed(), nullptr);
+    EXPECT_EQ(unpacked->nodes().at(0)->line, 1U);
+    EXPECT_EQ(unpacked->nodes().at(1)->line, 2U);
+    EXPECT_EQ(unpacked->nodes().at(2)->line, 3U);
+  }
+  // An empty list has no elements either way.
+  EXPECT_EQ(parseList("[]")->size(), 0U);
+}
+
 TEST(ConfigGrammar, VALUE) {
   // NOTE: Can't use the `checkResult` helper here due to the need to check multiple types.
   auto checkValue = [](const std::string& input) {
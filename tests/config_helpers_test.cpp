@@ -1,11 +1,16 @@
 #include <gtest/gtest.h>
 
 #include <magic_enum.hpp>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include "flexi_cfg/config/classes.h"
 #include "flexi_cfg/config/exceptions.h"
 #include "flexi_cfg/config/helpers.h"
 #include "flexi_cfg/logger.h"
+#include "flexi_cfg/utils.h"
 
 namespace {
 template <typename T, typename... Args>
@@ -459,6 +464,157 @@ TEST(ConfigHelpers, replaceVarInStr) {
 
     EXPECT_NE(output, expected);
   }
+
+  {
+    // The value of one var may contain other vars (in any order).
+    const std::string input = "$A.$C";
+    const std::string expected = "x.x";
+
+    const flexi_cfg::config::types::RefMap ref_vars = {
+        {"$A", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("$B")", kValue)},
+        {"$B", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("x")", kValue)},
+        {"$C", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("${A}")", kValue)}};
+
+    const auto output = flexi_cfg::config::helpers::replaceVarInStr(input, ref_vars);
+
+    EXPECT_EQ(output, expected);
+  }
+
+  {
+    // A var that refers to itself is only replaced a limited number of times.
+    const std::string input = "$A";
+    const std::string expected = "$A";
+
+    const flexi_cfg::config::types::RefMap ref_vars = {
+        {"$A", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("$A")", kValue)}};
+
+    const auto output = flexi_cfg::config::helpers::replaceVarInStr(input, ref_vars);
+
+    EXPECT_EQ(output, expected);
+  }
+
+  {
+    // The longest var that starts an un-braced var is replaced.
+    const std::string input = "$NAME_X.${NAME_X}.$NAME_Y";
+    const std::string expected = "m.m.n_Y";
+
+    const flexi_cfg::config::types::RefMap ref_vars = {
+        {"$NAME", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("n")", kValue)},
+        {"$NAME_X", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("m")", kValue)}};
+
+    const auto output = flexi_cfg::config::helpers::replaceVarInStr(input, ref_vars);
+
+    EXPECT_EQ(output, expected);
+  }
+
+  {
+    // A '$' in the value of a var that isn't part of a var is kept as is.
+    const std::string input = "a$A.${A}";
+    const std::string expected = "a$$.$$";
+
+    const flexi_cfg::config::types::RefMap ref_vars = {
+        {"$A", std::make_shared<flexi_cfg::config::types::ConfigValue>(R"("$$")", kValue)}};
+
+    const auto output = flexi_cfg::config::helpers::replaceVarInStr(input, ref_vars);
+
+    EXPECT_EQ(output, expected);
+  }
+}
+
+TEST(ConfigHelpers, expressionTokens) {
+  using Kind = flexi_cfg::config::types::ConfigExpression::Token::Kind;
+  const auto tokens = flexi_cfg::config::types::ConfigExpression::tokenize(
+      "{{ 0.5 * ($MAX_1 - ${MIN}) + $(a.$KEY.b) }}");
+
+  const std::vector<std::tuple<Kind, std::string, bool>> expected = {
+      {Kind::kLiteral, "{{ 0.5 * (", false}, {Kind::kVar, "$MAX_1", false},
+      {Kind::kLiteral, " - ", false},        {Kind::kVar, "$MIN", true},
+      {Kind::kLiteral, ") + ", false},       {Kind::kValueLookup, "a.$KEY.b", false},
+      {Kind::kLiteral, " }}", false}};
+  ASSERT_EQ(tokens.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(tokens[i].kind, std::get<0>(expected[i])) << i;
+    EXPECT_EQ(tokens[i].text, std::get<1>(expected[i])) << i;
+    EXPECT_EQ(tokens[i].braced, std::get<2>(expected[i])) << i;
+  }
+
+  // The value lookup is split into literal text & vars as well.
+  const auto& parts = tokens[5].parts;
+  ASSERT_EQ(parts.size(), 3);
+  EXPECT_EQ(parts[0].text, "a.");
+  EXPECT_EQ(parts[1].kind, Kind::kVar);
+  EXPECT_EQ(parts[1].text, "$KEY");
+  EXPECT_EQ(parts[2].text, ".b");
+}
+
+TEST(ConfigHelpers, replaceProtoVarInExpression) {
+  const auto makeExpression = [](const std::string& expression,
+                                 const std::vector<std::string>& lookups) {
+    flexi_cfg::config::types::CfgMap value_lookups;
+    for (const auto& l : lookups) {
+      value_lookups[l] = std::make_shared<flexi_cfg::config::types::ConfigValueLookup>(l);
+    }
+    return std::make_shared<flexi_cfg::config::types::ConfigExpression>(expression,
+                                                                        value_lookups);
+  };
+  const flexi_cfg::config::types::RefMap ref_vars = {
+      {"$PARENT_NAME",
+       std::make_shared<flexi_cfg::config::types::ConfigValue>("parent", kValue)},
+      {"$MAX", std::make_shared<flexi_cfg::config::types::ConfigValue>(
+                   "1.5", flexi_cfg::config::types::Type::kNumber)},
+      {"$MIN", std::make_shared<flexi_cfg::config::types::ConfigValue>(
+                   "-2", flexi_cfg::config::types::Type::kNumber)},
+      {"$KEY", std::make_shared<flexi_cfg::config::types::ConfigValue>(
+                   R"("c")", flexi_cfg::config::types::Type::kString)},
+      {"$HEX", std::make_shared<flexi_cfg::config::types::ConfigValue>(
+                   "0x10", flexi_cfg::config::types::Type::kNumber)}};
+
+  {
+    // Numeric vars
+    flexi_cfg::config::types::CfgMap cfg = {
+        {"expr", makeExpression("{{ 0.5 * ($MAX - ${MIN}) + $(a.b) }}", {"a.b"})}};
+    ASSERT_NO_THROW(flexi_cfg::config::helpers::replaceProtoVar(cfg, ref_vars));
+    const auto expr =
+        dynamic_pointer_cast<flexi_cfg::config::types::ConfigExpression>(cfg.at("expr"));
+    ASSERT_NE(expr, nullptr);
+    EXPECT_EQ(expr->value, "{{ 0.5 * (1.5 - -2) + $(a.b) }}");
+    EXPECT_FALSE(expr->hasVars());
+    ASSERT_EQ(expr->value_lookups.size(), 1);
+    EXPECT_TRUE(expr->value_lookups.contains("a.b"));
+  }
+  {
+    // A var within a value lookup changes the value lookup.
+    flexi_cfg::config::types::CfgMap cfg = {
+        {"expr", makeExpression("{{ $MAX * $(a.$KEY) }}", {"a.$KEY"})}};
+    ASSERT_NO_THROW(flexi_cfg::config::helpers::replaceProtoVar(cfg, ref_vars));
+    const auto expr =
+        dynamic_pointer_cast<flexi_cfg::config::types::ConfigExpression>(cfg.at("expr"));
+    ASSERT_NE(expr, nullptr);
+    EXPECT_EQ(expr->value, "{{ 1.5 * $(a.c) }}");
+    ASSERT_EQ(expr->value_lookups.size(), 1);
+    EXPECT_TRUE(expr->value_lookups.contains("a.c"));
+  }
+  {
+    // Each value lookup is rebuilt in order, and hex numbers are replaced by their value.
+    flexi_cfg::config::types::CfgMap cfg = {
+        {"expr",
+         makeExpression("{{ $(a.${KEY}.$KEY) + $HEX * $(a.b) }}", {"a.${KEY}.$KEY", "a.b"})}};
+    ASSERT_NO_THROW(flexi_cfg::config::helpers::replaceProtoVar(cfg, ref_vars));
+    const auto expr =
+        dynamic_pointer_cast<flexi_cfg::config::types::ConfigExpression>(cfg.at("expr"));
+    ASSERT_NE(expr, nullptr);
+    EXPECT_EQ(expr->value, "{{ $(a.c.c) + 16 * $(a.b) }}");
+    EXPECT_FALSE(expr->hasVars());
+    ASSERT_EQ(expr->value_lookups.size(), 2);
+    EXPECT_EQ(expr->value_lookups.begin()->first, "a.c.c");
+    EXPECT_EQ(std::next(expr->value_lookups.begin())->first, "a.b");
+  }
+  {
+    // Undefined vars are an error.
+    flexi_cfg::config::types::CfgMap cfg = {{"expr", makeExpression("{{ $MAX * $UNDEF }}", {})}};
+    EXPECT_THROW(flexi_cfg::config::helpers::replaceProtoVar(cfg, ref_vars),
+                 flexi_cfg::config::InvalidConfigException);
+  }
 }
 
 // TODO(miker2): Test for replaceProtoVar
@@ -586,6 +742,22 @@ TEST(ConfigHelpers, getConfigValue) {
         std::ignore = flexi_cfg::config::helpers::getConfigValue(cfg, {"outer", "doesnt_exist"}),
         flexi_cfg::config::InvalidKeyException);
   }
+  {
+    // The flat key is split lazily, but the results (and errors) are the same.
+    using flexi_cfg::utils::splitView;
+    EXPECT_EQ(flexi_cfg::config::helpers::getConfigValue(cfg, splitView("outer.inner.key1")),
+              flexi_cfg::config::helpers::getConfigValue(cfg, {"outer", "inner", "key1"}));
+    EXPECT_EQ(flexi_cfg::config::helpers::getConfigValue(cfg, splitView("top_level")),
+              flexi_cfg::config::helpers::getConfigValue(cfg, {"top_level"}));
+    EXPECT_THROW(std::ignore = flexi_cfg::config::helpers::getConfigValue(
+                     cfg, splitView("outer.inner.doesnt_exist")),
+                 flexi_cfg::config::InvalidKeyException);
+    EXPECT_THROW(std::ignore = flexi_cfg::config::helpers::getConfigValue(
+                     cfg, splitView("outer.inner.key1.doesnt_exist")),
+                 flexi_cfg::config::InvalidTypeException);
+    EXPECT_THROW(std::ignore = flexi_cfg::config::helpers::getConfigValue(cfg, splitView("")),
+                 flexi_cfg::config::InvalidKeyException);
+  }
 }
 
 TEST(ConfigHelpers, resolveVarRefs) {
@@ -648,3 +820,74 @@ TEST(ConfigHelpers, mergeNestedMapsWithDifferentKeyOrder) {
   flexi_cfg::config::types::CfgMap cfg_out{};
   ASSERT_THROW(cfg_out = flexi_cfg::config::helpers::mergeNestedMaps(cfg1, cfg2), flexi_cfg::config::DuplicateKeyException);
 }
+
+TEST(ConfigHelpers, mergeNested) {
+  const auto makeStruct = [](const std::string& name, const std::vector<std::string>& keys) {
+    auto cfg_struct = std::make_shared<flexi_cfg::config::types::ConfigStruct>(name, 0);
+    for (const auto& k : keys) {
+      cfg_struct->data[k] = std::make_shared<flexi_cfg::config::types::ConfigValue>(k, kValue);
+    }
+    return cfg_struct;
+  };
+  const auto makeValue = [](const std::string& value) {
+    return std::make_shared<flexi_cfg::config::types::ConfigValue>(value, kValue);
+  };
+
+  {
+    // Empty input results in an empty map.
+    EXPECT_TRUE(flexi_cfg::config::helpers::mergeNested({}).empty());
+  }
+  {
+    // cfg1 is:           cfg2 is:          cfg3 is:
+    //  struct foo         struct bar        struct foo
+    //    key1 = ""          key3 = ""         key2 = ""
+    //  a = ""             b = ""            struct bar
+    //                                         key4 = ""
+    std::vector<flexi_cfg::config::types::CfgMap> in(3);
+    in[0]["foo"] = makeStruct("foo", {"key1"});
+    in[0]["a"] = makeValue("a");
+    in[1]["bar"] = makeStruct("bar", {"key3"});
+    in[1]["b"] = makeValue("b");
+    in[2]["foo"] = makeStruct("foo", {"key2"});
+    in[2]["bar"] = makeStruct("bar", {"key4"});
+
+    flexi_cfg::config::types::CfgMap cfg_out{};
+    ASSERT_NO_THROW(cfg_out = flexi_cfg::config::helpers::mergeNested(std::move(in)));
+
+    // The keys are in the order in which they were first seen.
+    const std::vector<std::string> expected_keys = {"foo", "a", "bar", "b"};
+    ASSERT_EQ(cfg_out.size(), expected_keys.size());
+    auto it = cfg_out.begin();
+    for (const auto& k : expected_keys) {
+      EXPECT_EQ((it++)->first, k);
+    }
+
+    const auto foo =
+        dynamic_pointer_cast<flexi_cfg::config::types::ConfigStruct>(cfg_out.at("foo"));
+    ASSERT_EQ(foo->data.size(), 2);
+    EXPECT_EQ(foo->data.begin()->first, "key1");
+    EXPECT_TRUE(foo->data.contains("key2"));
+    const auto bar =
+        dynamic_pointer_cast<flexi_cfg::config::types::ConfigStruct>(cfg_out.at("bar"));
+    ASSERT_EQ(bar->data.size(), 2);
+    EXPECT_EQ(bar->data.begin()->first, "key3");
+    EXPECT_TRUE(bar->data.contains("key4"));
+  }
+  {
+    // A duplicate key in any of the maps is an error, no matter how deeply nested.
+    std::vector<flexi_cfg::config::types::CfgMap> in(3);
+    in[0]["foo"] = makeStruct("foo", {"key1"});
+    in[1]["bar"] = makeStruct("bar", {"key2"});
+    in[2]["foo"] = makeStruct("foo", {"key1"});
+    EXPECT_THROW(flexi_cfg::config::helpers::mergeNested(std::move(in)),
+                 flexi_cfg::config::DuplicateKeyException);
+  }
+  {
+    // A struct and a value with the same key can't be merged.
+    std::vector<flexi_cfg::config::types::CfgMap> in(2);
+    in[0]["foo"] = makeStruct("foo", {"key1"});
+    in[1]["foo"] = makeValue("foo");
+    EXPECT_THROW(flexi_cfg::config::helpers::mergeNested(std::move(in)),
+                 flexi_cfg::config::MismatchKeyException);
+  }
+}
@@ -1,13 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <atomic>
 #include <cmath>
+#include <cstdio>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <random>
 #include <regex>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <tao/pegtl.hpp>
 #include <tao/pegtl/contrib/parse_tree.hpp>
 #include <thread>
+#include <utility>
 
 #include "flexi_cfg/config/actions.h"
 #include "flexi_cfg/config/grammar.h"
@@ -51,6 +60,11 @@ TEST_P(InputString, Reader) {
   EXPECT_NO_THROW(cfg = flexi_cfg::Parser::parseFromString(GetParam(), "From String"));
   EXPECT_TRUE(cfg.exists("test1.key1"));
   EXPECT_EQ(cfg.getValue<std::string>("test1.key1"), "value");
+  EXPECT_EQ(cfg.getValue<std::string_view>("test1.key1"), "value");
+  EXPECT_EQ(cfg.getValue<std::string_view>("test1.key1").data(),
+            cfg.getValue<std::string_view>("test1.key1").data());
+  EXPECT_THROW(cfg.getValue<std::string_view>("test1.key2"),
+               flexi_cfg::config::MismatchTypeException);
   EXPECT_EQ(cfg.getType("test1.key1"), flexi_cfg::config::types::Type::kString);
   EXPECT_TRUE(cfg.exists("test1.key2"));
   EXPECT_FLOAT_EQ(cfg.getValue<float>("test1.key2"), 1.342F);
@@ -126,6 +140,156 @@ TEST_P(InputString, Reader) {
   }
 }
 
+TEST_P(InputString, FrozenReader) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  flexi_cfg::Reader cfg({}, "");
+  EXPECT_NO_THROW(cfg = flexi_cfg::Parser::parseFromString(GetParam(), "From String"));
+  auto frozen = cfg;
+  frozen.freeze();
+  EXPECT_FALSE(cfg.frozen());
+  EXPECT_TRUE(frozen.frozen());
+
+  // The frozen reader should behave identically to the original one.
+  EXPECT_EQ(frozen.keys(), cfg.keys());
+  for (const auto& key : {"test1", "test1.key1", "test2.inner.list", "test1.missing",
+                          "test1.key1.missing", "missing.key"}) {
+    EXPECT_EQ(frozen.exists(key), cfg.exists(key)) << key;
+  }
+  for (const auto& key : {"test1", "test1.key1", "test1.key2", "test2.n_key", "test2.inner.list"}) {
+    EXPECT_EQ(frozen.getType(key), cfg.getType(key)) << key;
+  }
+  EXPECT_EQ(frozen.getValue<std::string>("test1.key1"), "value");
+  EXPECT_EQ(frozen.getValue<std::string_view>("test1.key1"), "value");
+  // The view refers to the frozen config rather than a copy.
+  EXPECT_EQ(frozen.getValue<std::string_view>("test1.key1").data(),
+            frozen.getValue<std::string_view>("test1.key1").data());
+  EXPECT_FLOAT_EQ(frozen.getValue<float>("test1.key2"), 1.342F);
+  EXPECT_EQ(frozen.getValue<int>("test1.key3"), 10);
+  EXPECT_EQ(frozen.getValue<bool>("test2.n_key"), true);
+  EXPECT_EQ(frozen.getValue<std::vector<int>>("test2.inner.list"), std::vector({1, 2, 3, 4}));
+  EXPECT_EQ((frozen.getValue<std::array<int, 3>>("test2.inner.listWithVarRef")),
+            (std::array<int, 3>{1, 2, 4}));
+  EXPECT_EQ(frozen.getValue<std::vector<float>>("test2.inner.listWithExpression"),
+            cfg.getValue<std::vector<float>>("test2.inner.listWithExpression"));
+  EXPECT_EQ(frozen.findStructsWithKey("list"), cfg.findStructsWithKey("list"));
+
+  EXPECT_THROW(frozen.getValue<int>("test1.missing"), flexi_cfg::config::InvalidKeyException);
+  EXPECT_THROW(frozen.getValue<int>("test1.key1.x"), flexi_cfg::config::InvalidTypeException);
+  EXPECT_THROW(frozen.getValue<int>("test1.key1"), flexi_cfg::config::MismatchTypeException);
+  EXPECT_THROW(frozen.getValue<std::vector<int>>("test1.key3"),
+               flexi_cfg::config::InvalidTypeException);
+  EXPECT_THROW((frozen.getValue<std::array<int, 2>>("test2.inner.list")),
+               flexi_cfg::config::Exception);
+
+  // Readers of nested structs share the frozen config.
+  const auto inner = frozen.getValue<flexi_cfg::Reader>("test2.inner");
+  EXPECT_TRUE(inner.frozen());
+  EXPECT_EQ(inner.keys(), cfg.getValue<flexi_cfg::Reader>("test2.inner").keys());
+  EXPECT_EQ(inner.getValue<std::vector<int>>("list"), std::vector({1, 2, 3, 4}));
+  EXPECT_THROW(frozen.getValue<flexi_cfg::Reader>("test1.key1"),
+               flexi_cfg::config::MismatchTypeException);
+
+  // A nested reader refers to its struct within the shared config, so it can outlive the reader
+  // it was obtained from.
+  for (const bool freeze : {false, true}) {
+    std::optional<flexi_cfg::Reader> parent = flexi_cfg::Parser::parseFromString(GetParam(), "");
+    if (freeze) {
+      parent->freeze();
+    }
+    const auto nested = parent->getValue<flexi_cfg::Reader>("test2");
+    parent.reset();
+    std::stringstream nested_ss;
+    std::stringstream expected_ss;
+    nested.dump(nested_ss);
+    cfg.getValue<flexi_cfg::Reader>("test2").dump(expected_ss);
+    EXPECT_EQ(nested_ss.str(), expected_ss.str());
+    EXPECT_EQ(nested.frozen(), freeze);
+    EXPECT_EQ(nested.getValue<flexi_cfg::Reader>("inner").getValue<std::vector<int>>("list"),
+              std::vector({1, 2, 3, 4}));
+  }
+}
+
+TEST(ConfigParse, FrozenCfgCopy) {
+  namespace types = flexi_cfg::config::types;
+  auto outer = std::make_shared<types::ConfigStruct>("outer", 0);
+  outer->data["key"] = std::make_shared<types::ConfigValue>("13", types::Type::kNumber);
+  types::CfgMap cfg;
+  cfg["outer"] = outer;
+  cfg["name"] = std::make_shared<types::ConfigValue>("\"value\"", types::Type::kString);
+
+  // The strings (and the key index) are owned by each frozen tree, so the copies must not refer to
+  // the original once it is gone, and a moved tree must keep them.
+  auto original = std::make_unique<types::FrozenCfg>(std::make_shared<const types::CfgMap>(cfg));
+  const types::FrozenCfg copied{*original};
+  types::FrozenCfg assigned{std::make_shared<const types::CfgMap>()};
+  assigned = *original;
+  auto temporary = std::make_unique<types::FrozenCfg>(*original);
+  const types::FrozenCfg moved{std::move(*temporary)};
+  original.reset();
+  temporary.reset();
+
+  for (const auto* frozen : std::array<const types::FrozenCfg*, 3>{&copied, &assigned, &moved}) {
+    const auto key = frozen->find(types::FrozenCfg::root, "outer.key");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(frozen->key(*key), "key");
+    EXPECT_EQ(frozen->path(*key), "outer.key");
+    EXPECT_EQ(frozen->value(*key), "13");
+    const auto outer_idx = frozen->get(types::FrozenCfg::root, "outer");
+    EXPECT_EQ(frozen->find(outer_idx, "key"), key);
+    EXPECT_EQ(frozen->value(frozen->get(types::FrozenCfg::root, "name")), "value");
+    EXPECT_FALSE(frozen->find(types::FrozenCfg::root, "outer.missing").has_value());
+  }
+}
+
+TEST_P(InputString, KeyHandles) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  flexi_cfg::Reader cfg({}, "");
+  EXPECT_NO_THROW(cfg = flexi_cfg::Parser::parseFromString(GetParam(), "From String"));
+  auto frozen = cfg;
+  frozen.freeze();
+
+  for (const auto* reader : {&cfg, &frozen}) {
+    const auto key1 = reader->key("test1.key1");
+    EXPECT_EQ(key1.str(), "test1.key1");
+    EXPECT_EQ(reader->getValue<std::string>(key1), "value");
+    const auto key3 = reader->key<int>("test1.key3");
+    EXPECT_EQ(reader->getValue(key3), 10);
+    const auto list = reader->key<std::vector<int>>("test2.inner.list");
+    EXPECT_EQ(reader->getValue(list), std::vector({1, 2, 3, 4}));
+    EXPECT_EQ((reader->getValue<std::array<int, 3>>(reader->key("test2.inner.listWithVarRef"))),
+              (std::array<int, 3>{1, 2, 4}));
+
+    // Missing keys & bad types are reported when the handle is created.
+    EXPECT_THROW(std::ignore = reader->key("test1.missing"),
+                 flexi_cfg::config::InvalidKeyException);
+    EXPECT_THROW(std::ignore = reader->key<int>("test1.key1"),
+                 flexi_cfg::config::MismatchTypeException);
+    EXPECT_THROW(std::ignore = reader->getValue<int>(key1),
+                 flexi_cfg::config::MismatchTypeException);
+  }
+
+  // Handles that weren't created by a reader (or were created by another one) still work.
+  const flexi_cfg::Reader::Key key{"test2.inner.list"};
+  EXPECT_EQ(cfg.getValue<std::vector<int>>(key), std::vector({1, 2, 3, 4}));
+  EXPECT_EQ(frozen.getValue<std::vector<int>>(key), std::vector({1, 2, 3, 4}));
+  EXPECT_EQ(frozen.getValue<int>(cfg.key("test1.key3")), 10);
+  EXPECT_EQ(cfg.getValue<int>(frozen.key("test1.key3")), 10);
+  EXPECT_EQ(frozen.getValue(cfg.key<int>("test1.key3")), 10);
+  EXPECT_EQ(cfg.getValue(frozen.key<std::vector<int>>("test2.inner.list")),
+            std::vector({1, 2, 3, 4}));
+  EXPECT_THROW(std::ignore = cfg.getValue<int>(flexi_cfg::Reader::Key{"test1.missing"}),
+               flexi_cfg::config::InvalidKeyException);
+  EXPECT_THROW(std::ignore = frozen.getValue<int>(flexi_cfg::Reader::Key{"test1.missing"}),
+               flexi_cfg::config::InvalidKeyException);
+
+  // A handle created from a nested reader is relative to that reader.
+  const auto inner = frozen.getValue<flexi_cfg::Reader>("test2.inner");
+  const auto inner_list = inner.key("list");
+  EXPECT_EQ(inner.getValue<std::vector<int>>(inner_list), std::vector({1, 2, 3, 4}));
+  EXPECT_THROW(std::ignore = frozen.getValue<std::vector<int>>(inner_list),
+               flexi_cfg::config::InvalidKeyException);
+}
+
 // Ensure we don't get optimized out and force "consuming" the value
 #pragma GCC push_options
 #pragma GCC optimize("-O0")
@@ -194,6 +358,91 @@ TEST_P(InputString, MultiThreadedConfigAccess) {
   flexi_cfg::logger::info("MultiThreaded Test Done");
 }
 
+// Any number of threads can read from a frozen reader (and the readers obtained from it) at once.
+// This is also meant to be run under ThreadSanitizer (see `CFG_ENABLE_TSAN`).
+TEST_P(InputString, FrozenConcurrentReads) {
+  using flexi_cfg::config::types::Type;
+  auto cfg = flexi_cfg::Parser::parseFromString(GetParam(), "From String");
+  cfg.freeze();
+
+  // The value of every leaf, as read by a single thread.
+  struct Leaf {
+    std::string parent;
+    std::string key;
+    Type type{};
+    double number{};
+    bool boolean{};
+    std::string_view str{};
+  };
+  std::vector<Leaf> leaves;
+  const auto collect = [&cfg, &leaves](const auto& self, const std::string& parent) -> void {
+    const auto reader = parent.empty() ? cfg : cfg.getValue<flexi_cfg::Reader>(parent);
+    for (const auto& key : reader.keys()) {
+      Leaf leaf{.parent = parent, .key = key, .type = reader.getType(key)};
+      switch (leaf.type) {
+        case Type::kNumber:
+          leaf.number = reader.getValue<double>(key);
+          break;
+        case Type::kBoolean:
+          leaf.boolean = reader.getValue<bool>(key);
+          break;
+        case Type::kString:
+          leaf.str = reader.getValue<std::string_view>(key);
+          break;
+        case Type::kStruct:
+        case Type::kStructInProto:
+          self(self, flexi_cfg::utils::makeName(parent, key));
+          continue;
+        default:
+          continue;
+      }
+      leaves.push_back(std::move(leaf));
+    }
+  };
+  collect(collect, "");
+  ASSERT_FALSE(leaves.empty());
+
+  constexpr auto thread_count = 8;
+  constexpr auto reads_per_thread = 20000;
+  std::atomic<std::size_t> mismatches{0};
+  auto random_reads = [&cfg, &leaves, &mismatches](unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, leaves.size() - 1);
+    for (auto i = 0; i < reads_per_thread; ++i) {
+      const auto& leaf = leaves[pick(rng)];
+      // Alternate between reading the full key and reading through a sub-reader.
+      const bool full_key = i % 2 == 0 || leaf.parent.empty();
+      const auto reader = full_key ? cfg : cfg.getValue<flexi_cfg::Reader>(leaf.parent);
+      const auto key = full_key ? flexi_cfg::utils::makeName(leaf.parent, leaf.key) : leaf.key;
+      bool match = false;
+      switch (leaf.type) {
+        case Type::kNumber:
+          match = reader.getValue<double>(key) == leaf.number;
+          break;
+        case Type::kBoolean:
+          match = reader.getValue<bool>(key) == leaf.boolean;
+          break;
+        default:
+          match = reader.getValue<std::string_view>(key) == leaf.str;
+          break;
+      }
+      if (!match) {
+        ++mismatches;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (auto i = 0; i < thread_count; i++) {
+    threads.emplace_back(random_reads, i);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(ConfigParse, InputString, testing::Values(std::string(R"(
 
 struct test1 {
@@ -317,6 +566,278 @@ TEST(ConfigParse, ConfigRoot) {
       std::filesystem::path("config_root/test/config_example_base.cfg"), baseDir()));
 }
 
+TEST(ConfigParse, ParseStats) {
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::WARN);
+  flexi_cfg::ParseStats stats;
+  EXPECT_NO_THROW(flexi_cfg::parse(baseDir() / "config_example5.cfg", std::nullopt, &stats));
+
+  ASSERT_EQ(stats.phases.size(), 9U);
+  EXPECT_EQ(stats.phases.front().first, "FlattenAndFindProtos");
+  EXPECT_EQ(stats.phases.back().first, "CleanupConfig");
+  // The root file and its two includes. The root file finishes last.
+  ASSERT_EQ(stats.files.size(), 3U);
+  EXPECT_EQ(std::filesystem::path(stats.files.back().first).filename(), "config_example5.cfg");
+  EXPECT_GE(stats.total, stats.parse);
+  EXPECT_GE(stats.parse, stats.files.back().second);
+
+  EXPECT_GT(stats.nodes_created, 0U);
+  EXPECT_GT(stats.peak_nodes, 0U);
+  EXPECT_LE(stats.peak_nodes, stats.nodes_created);
+  EXPECT_GT(stats.clones, 0U);
+  EXPECT_GT(stats.var_substitutions, 0U);
+  EXPECT_EQ(stats.expressions_evaluated, 1U);
+
+  // Re-using the stats object starts from scratch.
+  const auto nodes_created = stats.nodes_created;
+  EXPECT_NO_THROW(flexi_cfg::parse(baseDir() / "config_example5.cfg", std::nullopt, &stats));
+  EXPECT_EQ(stats.files.size(), 3U);
+  EXPECT_EQ(stats.nodes_created, nodes_created);
+
+  // Nothing is collected when parsing without stats.
+  EXPECT_NO_THROW(flexi_cfg::parse(baseDir() / "config_example5.cfg"));
+  EXPECT_EQ(stats.nodes_created, nodes_created);
+}
+
+TEST(ConfigParse, ParseThreaded) {
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::ERROR);
+  const auto json = [](const flexi_cfg::Reader& cfg) {
+    auto visitor = flexi_cfg::visitor::JsonVisitor();
+    cfg.visit(visitor);
+    return std::string(visitor);
+  };
+  const auto error = [](const std::filesystem::path& file, unsigned threads) {
+    try {
+      flexi_cfg::parse(file, baseDir(), nullptr, threads);
+    } catch (const std::exception& e) {
+      return std::string(e.what());
+    }
+    return std::string();
+  };
+
+  // Parsing the files concurrently gives the same config as parsing them one after another.
+  const auto files = {"config_example5.cfg", "config_example16.cfg", "nested/dupe_include2.cfg",
+                      "config_root/test/config_example_base.cfg"};
+  for (const auto* file : files) {
+    const auto expected = json(flexi_cfg::parse(file, baseDir()));
+    for (const auto threads : {0U, 2U, 8U}) {
+      EXPECT_EQ(json(flexi_cfg::parse(file, baseDir(), nullptr, threads)), expected)
+          << file << " (" << threads << " threads)";
+    }
+  }
+
+  // The files are listed in the same order in the stats.
+  flexi_cfg::ParseStats serial;
+  flexi_cfg::ParseStats threaded;
+  flexi_cfg::parse("config_example5.cfg", baseDir(), &serial);
+  flexi_cfg::parse("config_example5.cfg", baseDir(), &threaded, 4);
+  ASSERT_EQ(threaded.files.size(), serial.files.size());
+  for (std::size_t i = 0; i < serial.files.size(); ++i) {
+    EXPECT_EQ(threaded.files[i].first, serial.files[i].first);
+  }
+  EXPECT_EQ(threaded.nodes_created, serial.nodes_created);
+
+  // So are the errors (including duplicate keys that are only found once the files are joined up)
+  // and the messages logged along the way, which are only logged once.
+  const auto logged = [](const auto& fn) {
+    testing::internal::CaptureStdout();
+    fn();
+    std::fflush(stdout);
+    return testing::internal::GetCapturedStdout();
+  };
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("flexi_cfg_parse_test_" + std::to_string(std::random_device{}()));
+  std::filesystem::create_directories(dir);
+  std::ofstream(dir / "included.cfg") << "key = 1\n";
+  std::ofstream(dir / "duplicate_key.cfg") << "include_relative included.cfg\nkey = 2\n";
+  for (const auto& file : {std::filesystem::path("nested/dupe_include.cfg"),
+                           std::filesystem::path("optional/optional_config_non_optional.cfg"),
+                           dir / "duplicate_key.cfg"}) {
+    std::string expected;
+    const auto expected_log = logged([&] { expected = error(file, 1); });
+    EXPECT_FALSE(expected.empty()) << file;
+    std::string actual;
+    EXPECT_EQ(logged([&] { actual = error(file, 4); }), expected_log) << file;
+    EXPECT_EQ(actual, expected) << file;
+  }
+  std::filesystem::remove_all(dir);
+
+  flexi_cfg::logger::setLevel(flexi_cfg::logger::Severity::WARN);
+  const auto* optional_file = "optional/optional_config3.cfg";
+  const auto expected_log = logged([&] { flexi_cfg::parse(optional_file, baseDir()); });
+  EXPECT_NE(expected_log.find("[optional]"), std::string::npos);
+  EXPECT_EQ(logged([&] { flexi_cfg::parse(optional_file, baseDir(), nullptr, 4); }), expected_log);
+}
+
+TEST(ConfigParse, SharedSource) {
+  // The nodes parsed from a source all refer to a single copy of its name.
+  peg::memory_input in("a = 1\nb = \"two\"\nc = [1, 2]\n", "shared source");
+  flexi_cfg::config::ActionData out;
+  ASSERT_TRUE((flexi_cfg::config::internal::parseCore<flexi_cfg::config::grammar,
+                                                      flexi_cfg::config::action>(in, out)));
+  const auto source = out.files->source("shared source");
+  EXPECT_EQ(*source, "shared source");
+  EXPECT_EQ(out.files->source("shared source"), source);
+  EXPECT_NE(out.files->source("other source"), source);
+  const auto& cfg = out.cfg_res.back();
+  for (const auto* key : {"a", "b", "c"}) {
+    EXPECT_EQ(cfg.at(key)->source, source) << key;
+  }
+  EXPECT_EQ(cfg.at("b")->loc(), "shared source:2");
+}
+
+TEST(ConfigParse, NumericConversions) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  const auto cfg = flexi_cfg::Parser::parseFromString(R"(
+small = 100
+negative = -100
+hex = 0xFF
+big = 0xFFFFFFFFFF
+float = 1.5e2
+)",
+                                                      "From String");
+  EXPECT_EQ(cfg.getValue<int8_t>("small"), 100);
+  EXPECT_EQ(cfg.getValue<int16_t>("negative"), -100);
+  EXPECT_EQ(cfg.getValue<uint8_t>("hex"), 255);
+  EXPECT_EQ(cfg.getValue<uint16_t>("hex"), 255);
+  EXPECT_EQ(cfg.getValue<uint32_t>("hex"), 255);
+  EXPECT_EQ(cfg.getValue<uint64_t>("big"), 0xFFFFFFFFFFULL);
+  EXPECT_DOUBLE_EQ(cfg.getValue<double>("hex"), 255.0);
+  EXPECT_FLOAT_EQ(cfg.getValue<float>("float"), 150.F);
+  EXPECT_DOUBLE_EQ(cfg.getValue<double>("negative"), -100.0);
+
+  EXPECT_THROW(std::ignore = cfg.getValue<int8_t>("hex"), std::out_of_range);
+  EXPECT_THROW(std::ignore = cfg.getValue<uint32_t>("big"), std::out_of_range);
+  EXPECT_THROW(std::ignore = cfg.getValue<uint8_t>("negative"),
+               flexi_cfg::config::MismatchTypeException);
+  EXPECT_THROW(std::ignore = cfg.getValue<int>("float"), flexi_cfg::config::MismatchTypeException);
+  try {
+    std::ignore = cfg.getValue<int>("big");
+    FAIL() << "Expected std::out_of_range";
+  } catch (const std::out_of_range& e) {
+    // The message is the same as it was when values were converted with `std::stoi`.
+    EXPECT_STREQ(e.what(), "stoi");
+  }
+  try {
+    std::ignore = cfg.getValue<int8_t>("hex");
+    FAIL() << "Expected std::out_of_range";
+  } catch (const std::out_of_range& e) {
+    // Types that were never read with `std::sto*` name the type instead.
+    EXPECT_NE(std::string_view(e.what()).find("out of range for type int8_t"),
+              std::string_view::npos);
+  }
+}
+
+TEST(ConfigParse, BulkValues) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  auto cfg = flexi_cfg::Parser::parseFromString(R"(
+flat = [1, 2.5, 3]
+table = [[1, 2, 3], [4, 5, 6]]
+ragged = [[1, 2], [3]]
+empty = []
+)",
+                                                "From String");
+  for (const bool frozen : {false, true}) {
+    if (frozen) {
+      cfg.freeze();
+    }
+    flexi_cfg::Reader::Shape shape;
+    EXPECT_EQ(cfg.getValues<double>("flat", &shape), std::vector<double>({1, 2.5, 3}));
+    EXPECT_EQ(shape, flexi_cfg::Reader::Shape({3}));
+    EXPECT_EQ(cfg.getValues<int>("table", &shape), std::vector<int>({1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(shape, flexi_cfg::Reader::Shape({2, 3}));
+    EXPECT_EQ(cfg.getShape("table"), flexi_cfg::Reader::Shape({2, 3}));
+    EXPECT_TRUE(cfg.getValues<double>("empty").empty());
+    EXPECT_EQ(cfg.getShape("empty"), flexi_cfg::Reader::Shape({0}));
+
+    std::array<float, 6> buffer{};
+    cfg.getValues<float>("table", buffer);
+    EXPECT_EQ(buffer, (std::array<float, 6>{1, 2, 3, 4, 5, 6}));
+    std::array<float, 4> small{};
+    EXPECT_THROW(cfg.getValues<float>("table", small), flexi_cfg::config::Exception);
+
+    EXPECT_THROW(std::ignore = cfg.getValues<double>("ragged"), flexi_cfg::config::Exception);
+    EXPECT_THROW(std::ignore = cfg.getValues<int>("flat"),
+                 flexi_cfg::config::MismatchTypeException);
+    EXPECT_THROW(std::ignore = cfg.getShape("flat.x"), flexi_cfg::config::InvalidTypeException);
+  }
+}
+
+namespace {
+struct Gains {
+  double kp{};
+  double ki{};
+  double kd{};
+};
+FLEXI_CFG_FIELDS(Gains, kp, ki, kd);
+
+struct Controller {
+  std::string name{};
+  bool enabled{};
+  Gains gains{};
+  std::vector<int> channels{};
+  std::array<float, 2> limits{};
+};
+FLEXI_CFG_FIELDS(Controller, name, enabled, gains, channels, limits);
+}  // namespace
+
+TEST(ConfigParse, Bind) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  auto cfg = flexi_cfg::Parser::parseFromString(R"(
+struct controller {
+  name = "pid"
+  enabled = true
+  channels = [1, 2, 3]
+  limits = [-1.5, 1.5]
+  struct gains {
+    kp = 1.5
+    ki = 0.25
+    kd = 0
+  }
+}
+struct broken {
+  name = 12
+  channels = [1, 2, 3]
+  limits = [0.5]
+  gains = 4
+}
+)",
+                                                "From String");
+  for (const bool frozen : {false, true}) {
+    if (frozen) {
+      cfg.freeze();
+    }
+    const auto controller = cfg.bind<Controller>("controller");
+    EXPECT_EQ(controller.name, "pid");
+    EXPECT_TRUE(controller.enabled);
+    EXPECT_EQ(controller.gains.kp, 1.5);
+    EXPECT_EQ(controller.gains.ki, 0.25);
+    EXPECT_EQ(controller.gains.kd, 0.0);
+    EXPECT_EQ(controller.channels, std::vector<int>({1, 2, 3}));
+    EXPECT_EQ(controller.limits, (std::array<float, 2>{-1.5, 1.5}));
+
+    Gains gains{};
+    cfg.bind("controller.gains", gains);
+    EXPECT_EQ(gains.ki, 0.25);
+    // The same as reading from a sub-reader.
+    EXPECT_EQ(cfg.getValue<flexi_cfg::Reader>("controller").bind<Gains>("gains").kp, 1.5);
+
+    // Every problem is reported at once.
+    try {
+      std::ignore = cfg.bind<Controller>("broken");
+      FAIL() << "Expected an exception";
+    } catch (const flexi_cfg::config::InvalidConfigException& e) {
+      const std::string what = e.what();
+      EXPECT_NE(what.find("4 field(s)"), std::string::npos) << what;
+      EXPECT_NE(what.find("'broken.name'"), std::string::npos) << what;
+      EXPECT_NE(what.find("Unable to find 'enabled' in 'broken'"), std::string::npos) << what;
+      EXPECT_NE(what.find("'broken.limits'"), std::string::npos) << what;
+      EXPECT_NE(what.find("'broken.gains'"), std::string::npos) << what;
+      EXPECT_EQ(what.find("'broken.channels'"), std::string::npos) << what;
+    }
+    EXPECT_THROW(std::ignore = cfg.bind<Gains>("missing"), flexi_cfg::config::InvalidKeyException);
+  }
+}
+
 TEST(ConfigVisitor, JsonConfigVisitor) {
   setLevel(flexi_cfg::logger::Severity::INFO);
   auto cfg = flexi_cfg::Parser::parse(std::filesystem::path("config_example16.cfg"), baseDir());
@@ -387,6 +908,19 @@ TEST(ConfigVisitor, JsonConfigVisitor) {
       json);
 }
 
+TEST(ConfigVisitor, FrozenConfigVisitor) {
+  setLevel(flexi_cfg::logger::Severity::INFO);
+  auto cfg = flexi_cfg::Parser::parse(std::filesystem::path("config_example16.cfg"), baseDir());
+  auto frozen = cfg;
+  frozen.freeze();
+
+  auto visitor = flexi_cfg::visitor::JsonVisitor();
+  cfg.visit(visitor);
+  auto frozen_visitor = flexi_cfg::visitor::JsonVisitor();
+  frozen.visit(frozen_visitor);
+  EXPECT_EQ(std::string(frozen_visitor), std::string(visitor));
+}
+
 TEST(ConfigVisitor, PrettyJsonConfigVisitor) {
   setLevel(flexi_cfg::logger::Severity::INFO);
   auto cfg = flexi_cfg::Parser::parse(std::filesystem::path("config_example16.cfg"), baseDir());
@@ -0,0 +1,111 @@
+#include "flexi_cfg/logger.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// \brief A type that counts the number of times it has been formatted.
+struct Counted {
+  std::size_t* n_formatted;
+};
+
+}  // namespace
+
+template <>
+struct fmt::formatter<Counted> : formatter<std::string_view> {
+  auto format(const Counted& counted, format_context& ctx) const {
+    ++(*counted.n_formatted);
+    return formatter<std::string_view>::format("counted", ctx);
+  }
+};
+
+using flexi_cfg::logger::Severity;
+
+TEST(Logger, Enabled) {
+  flexi_cfg::logger::setLevel(Severity::WARN);
+  EXPECT_FALSE(flexi_cfg::logger::enabled(Severity::INFO));
+  EXPECT_TRUE(flexi_cfg::logger::enabled(Severity::WARN));
+  EXPECT_TRUE(flexi_cfg::logger::enabled(Severity::CRITICAL));
+
+  flexi_cfg::logger::setLevel(Severity::TRACE);
+  EXPECT_EQ(flexi_cfg::logger::enabled(Severity::TRACE),
+            Severity::TRACE >= flexi_cfg::logger::MIN_LOG_LEVEL);
+  EXPECT_TRUE(flexi_cfg::logger::enabled(Severity::CRITICAL));
+}
+
+TEST(Logger, LazyFormatting) {
+  std::size_t n_formatted = 0;
+  const Counted counted{&n_formatted};
+
+  flexi_cfg::logger::setLevel(Severity::ERROR);
+  flexi_cfg::logger::trace("{}", counted);
+  flexi_cfg::logger::debug("{}", counted);
+  flexi_cfg::logger::info("{}", counted);
+  flexi_cfg::logger::warn("{}", counted);
+  EXPECT_EQ(n_formatted, 0);
+
+  // The arguments of the LOG macros aren't evaluated at all when the level is disabled.
+  std::size_t n_evaluated = 0;
+  LOG_W("{}", ++n_evaluated);
+  EXPECT_EQ(n_evaluated, 0);
+
+  flexi_cfg::logger::error("{}", counted);
+  EXPECT_EQ(n_formatted, 1);
+  LOG_E("{}", ++n_evaluated);
+  EXPECT_EQ(n_evaluated, 1);
+}
+
+// Logging (and changing the level) from several threads at once is safe. This is also meant to be
+// run under ThreadSanitizer (see `CFG_ENABLE_TSAN`).
+TEST(Logger, ConcurrentUse) {
+  constexpr auto thread_count = 4;
+  constexpr auto messages_per_thread = 10;
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (auto i = 0; i < thread_count; ++i) {
+    threads.emplace_back([i] {
+      for (auto j = 0; j < messages_per_thread; ++j) {
+        flexi_cfg::logger::setLevel(j % 2 == 0 ? Severity::ERROR : Severity::CRITICAL);
+        flexi_cfg::logger::debug("thread {}, message {}", i, j);
+        flexi_cfg::logger::critical("thread {}, message {}", i, j);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_TRUE(flexi_cfg::logger::enabled(Severity::CRITICAL));
+}
+
+TEST(Logger, Capture) {
+  flexi_cfg::logger::setLevel(Severity::WARN);
+  flexi_cfg::logger::Messages messages;
+  {
+    const flexi_cfg::logger::ScopedCapture capture{messages};
+    flexi_cfg::logger::info("not enabled");
+    flexi_cfg::logger::warn("held {}", 1);
+    // Other threads keep printing.
+    std::thread([] { flexi_cfg::logger::error("printed"); }).join();
+    flexi_cfg::logger::error("held");
+  }
+  ASSERT_EQ(messages.size(), 2U);
+  EXPECT_EQ(messages[0].first, Severity::WARN);
+  EXPECT_EQ(messages[0].second, "held 1");
+  EXPECT_EQ(messages[1].first, Severity::ERROR);
+  EXPECT_EQ(messages[1].second, "held");
+
+  testing::internal::CaptureStdout();
+  flexi_cfg::logger::replay(messages);
+  std::fflush(stdout);
+  const auto output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("held 1"), std::string::npos);
+  EXPECT_NE(output.find("held"), std::string::npos);
+}
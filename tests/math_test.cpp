@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <iostream>
+#include <memory>
 #include <tao/pegtl.hpp>
 #include <tao/pegtl/contrib/analyze.hpp>
 #include <tuple>
@@ -10,6 +11,7 @@
 #include "flexi_cfg/config/parser-internal.h"
 #include "flexi_cfg/math/actions.h"
 #include "flexi_cfg/math/grammar.h"
+#include "flexi_cfg/math/program.h"
 
 namespace peg = TAO_PEGTL_NAMESPACE;
 
@@ -82,3 +84,30 @@ TEST_F(MathExpressionTest, evaluate_var_ref) {
     EXPECT_FLOAT_EQ(result, std::get<1>(input));
   }
 }
+
+// NOLINTNEXTLINE
+TEST_F(MathExpressionTest, compile) {
+  for (const auto& input : test_strings) {
+    std::cout << "Input: " << input.first << std::endl;
+    std::shared_ptr<const flexi_cfg::math::Program> program;
+    ASSERT_NO_THROW(program = flexi_cfg::math::compile("{{" + input.first + "}}", "test"));
+    EXPECT_TRUE(program->slots.empty());
+    EXPECT_FLOAT_EQ(program->evaluate(), input.second);
+  }
+
+  for (const auto& input : test_w_var_ref) {
+    std::cout << "Input: " << std::get<0>(input) << std::endl;
+    const auto program = flexi_cfg::math::compile("{{" + std::get<0>(input) + "}}", "test");
+    const auto& ref_map = std::get<2>(input);
+    ASSERT_EQ(program->slots.size(), ref_map.size());
+    // The values must be supplied in the same order as the slots.
+    std::vector<double> values;
+    for (const auto& slot : program->slots) {
+      values.push_back(ref_map.at(slot));
+    }
+    EXPECT_FLOAT_EQ(program->evaluate(values), std::get<1>(input));
+    EXPECT_THROW(std::ignore = program->evaluate(), std::runtime_error);
+  }
+
+  EXPECT_THROW(flexi_cfg::math::compile("{{ 3 * }}", "test"), std::runtime_error);
+}
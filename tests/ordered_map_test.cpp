@@ -931,3 +931,73 @@ TEST(OrderedMap, EdgeCases) {
   EXPECT_EQ(map.size(), 2);
   EXPECT_FALSE(map.contains("four"));
 }
+
+TEST(OrderedMap, ManyElements) {
+  // Enough elements to grow the table several times, and enough erased elements to clear out the
+  // tombstones. The order must be preserved throughout.
+  constexpr int n = 1000;
+  OMap map;
+  for (int i = 0; i < n; ++i) {
+    map[std::to_string(i)] = i;
+  }
+  EXPECT_EQ(map.size(), n);
+
+  // Erase every other element (by key, by iterator & by range).
+  for (int i = 0; i < n / 2; i += 2) {
+    EXPECT_EQ(map.erase(std::to_string(i)), 1);
+  }
+  for (auto it = map.find(std::to_string(n / 2)); it != map.end();) {
+    it = it->second % 2 == 0 ? map.erase(it) : std::next(it);
+  }
+  EXPECT_EQ(map.size(), n / 2);
+  const auto first = map.find("1");
+  EXPECT_EQ(map.erase(first, std::next(first, 10))->first, "21");
+  EXPECT_EQ(map.size(), n / 2 - 10);
+
+  int expected = 21;
+  for (const auto& [key, value] : map) {
+    EXPECT_EQ(key, std::to_string(expected));
+    EXPECT_EQ(value, expected);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, n + 1);
+  EXPECT_EQ(std::distance(map.rbegin(), map.rend()), map.size());
+  EXPECT_EQ(map.rbegin()->first, std::to_string(n - 1));
+
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(map.contains(std::to_string(i)), i % 2 == 1 && i >= 21) << i;
+  }
+
+  // Re-inserted keys go to the end.
+  map["0"] = 0;
+  EXPECT_EQ(std::prev(map.end())->first, "0");
+  EXPECT_EQ(map.at("0"), 0);
+  EXPECT_EQ(map.begin()->first, "21");
+}
+
+TEST(OrderedMap, AssignWhileIterating) {
+  // Assigning to existing keys must leave the elements in place, even when the table is full and
+  // has tombstones. The keys are long enough to live on the heap.
+  const auto key = [](int i) { return fmt::format("a_key_that_is_too_long_for_sso_{}", i); };
+  OMap map;
+  for (int i = 0; i < 14; ++i) {
+    map[key(i)] = i;
+  }
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(map.erase(key(i)), 1);
+  }
+
+  const auto* first = &*map.begin();
+  for (auto& kv : map) {
+    map[kv.first] = kv.second * 10;
+  }
+  EXPECT_EQ(&*map.begin(), first);
+
+  int expected = 6;
+  for (const auto& [k, v] : map) {
+    EXPECT_EQ(k, key(expected));
+    EXPECT_EQ(v, expected * 10);
+    ++expected;
+  }
+  EXPECT_EQ(expected, 14);
+}
@@ -2,9 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <string>
+#include <system_error>
 #include <vector>
 
+#include "flexi_cfg/details/from_chars.h"
+
 namespace {
 void compareVecEq(const std::vector<std::string>& expected, const std::vector<std::string>& test) {
   ASSERT_EQ(expected.size(), test.size());
@@ -77,6 +81,40 @@ TEST(UtilsTest, split) {
   }
 }
 
+TEST(UtilsTest, splitView) {
+  // The lazy split must produce exactly the same parts as `split`, including the edge cases.
+  for (const std::string input :
+       {"this.is.a.test", "one_value", "", ".", "a..b", "a.b.", ".a", "..", "trailing.."}) {
+    const auto parts = flexi_cfg::utils::splitView(input);
+    std::vector<std::string> split;
+    for (const auto part : parts) {
+      // Each part is a view into the input.
+      EXPECT_GE(part.data(), input.data());
+      EXPECT_LE(part.data() + part.size(), input.data() + input.size());
+      split.emplace_back(part);
+    }
+    compareVecEq(flexi_cfg::utils::split(input, '.'), split);
+    EXPECT_EQ(parts.back(), split.empty() ? "" : split.back()) << input;
+  }
+
+  const std::string key = "outer.inner.key";
+  const auto parts = flexi_cfg::utils::splitView(key);
+  auto it = parts.begin();
+  EXPECT_EQ(parts.prefix(it), "");
+  EXPECT_EQ(parts.prefix(++it), "outer");
+  EXPECT_EQ(parts.prefix(++it), "outer.inner");
+  EXPECT_EQ(*it, "key");
+  EXPECT_EQ(++it, parts.end());
+
+  compareVecEq({"a", "b", "c"}, [] {
+    std::vector<std::string> out;
+    for (const auto part : flexi_cfg::utils::splitView("a;b;c", ';')) {
+      out.emplace_back(part);
+    }
+    return out;
+  }());
+}
+
 TEST(UtilsTest, join) {
   {
     const std::vector<std::string> input{"this", "is", "a", "test"};
@@ -151,3 +189,96 @@ TEST(UtilsTest, makeName) {
   }
   { EXPECT_THROW(flexi_cfg::utils::makeName("", ""), std::runtime_error); }
 }
+
+TEST(UtilsTest, replaceAll) {
+  {
+    // No instances
+    std::string s = "nothing to see here";
+    EXPECT_EQ(flexi_cfg::utils::replaceAll(s, "$VAR", "value"), 0);
+    EXPECT_EQ(s, "nothing to see here");
+  }
+  {
+    // Multiple instances, including at the beginning and end
+    std::string s = "$VAR.$VAR_X.${VAR}$VAR";
+    EXPECT_EQ(flexi_cfg::utils::replaceAll(s, "$VAR", "v"), 3);
+    EXPECT_EQ(s, "v.v_X.${VAR}v");
+  }
+  {
+    // Replacements aren't re-scanned
+    std::string s = "aaa";
+    EXPECT_EQ(flexi_cfg::utils::replaceAll(s, "a", "aa"), 3);
+    EXPECT_EQ(s, "aaaaaa");
+  }
+  {
+    // Matches don't overlap
+    std::string s = "aaa";
+    EXPECT_EQ(flexi_cfg::utils::replaceAll(s, "aa", "b"), 1);
+    EXPECT_EQ(s, "ba");
+  }
+  {
+    // An empty search string is a no-op
+    std::string s = "abc";
+    EXPECT_EQ(flexi_cfg::utils::replaceAll(s, "", "b"), 0);
+    EXPECT_EQ(s, "abc");
+  }
+}
+
+TEST(UtilsTest, fromChars) {
+  using flexi_cfg::details::fromChars;
+  {
+    // Accepts the same syntax as `std::stoi(str, nullptr, 0)`
+    int value{};
+    for (const auto& [str, expected] : std::vector<std::pair<std::string, int>>{
+             {"42", 42}, {"+42", 42}, {"-42", -42}, {" 42", 42}, {"0x2A", 42}, {"0X2a", 42},
+             {"-0x2A", -42}, {"052", 42}, {"0", 0}}) {
+      const auto result = fromChars(str, value);
+      EXPECT_EQ(result.ec, std::errc{}) << str;
+      EXPECT_EQ(result.processed, str.size()) << str;
+      EXPECT_EQ(value, expected) << str;
+    }
+  }
+  {
+    // Partial conversions report the number of characters processed
+    int value{};
+    EXPECT_EQ(fromChars("1.5", value).processed, 1U);
+    EXPECT_EQ(fromChars("0x", value).processed, 1U);
+    EXPECT_EQ(fromChars("12abc", value).processed, 2U);
+  }
+  {
+    // The limits of each type are respected
+    int8_t i8{};
+    EXPECT_EQ(fromChars("-128", i8).ec, std::errc{});
+    EXPECT_EQ(i8, INT8_MIN);
+    EXPECT_EQ(fromChars("128", i8).ec, std::errc::result_out_of_range);
+    uint8_t u8{};
+    EXPECT_EQ(fromChars("0xFF", u8).ec, std::errc{});
+    EXPECT_EQ(u8, UINT8_MAX);
+    EXPECT_EQ(fromChars("256", u8).ec, std::errc::result_out_of_range);
+    int64_t i64{};
+    EXPECT_EQ(fromChars("-9223372036854775808", i64).ec, std::errc{});
+    EXPECT_EQ(i64, INT64_MIN);
+    EXPECT_EQ(fromChars("9223372036854775808", i64).ec, std::errc::result_out_of_range);
+  }
+  {
+    double value{};
+    EXPECT_EQ(fromChars("-1.25e-3", value).ec, std::errc{});
+    EXPECT_DOUBLE_EQ(value, -1.25e-3);
+    EXPECT_EQ(fromChars("+.5", value).ec, std::errc{});
+    EXPECT_DOUBLE_EQ(value, 0.5);
+    EXPECT_EQ(fromChars("0x1F", value).ec, std::errc{});
+    EXPECT_DOUBLE_EQ(value, 31.0);
+    EXPECT_EQ(fromChars("1e400", value).ec, std::errc::result_out_of_range);
+    float f{};
+    EXPECT_EQ(fromChars("0.1", f).ec, std::errc{});
+    EXPECT_FLOAT_EQ(f, 0.1F);
+  }
+  {
+    // Nothing to convert
+    int i{};
+    double d{};
+    for (const std::string str : {"", "-", "abc", "+-1", "--1"}) {
+      EXPECT_EQ(fromChars(str, i).ec, std::errc::invalid_argument) << str;
+      EXPECT_EQ(fromChars(str, d).ec, std::errc::invalid_argument) << str;
+    }
+  }
+}